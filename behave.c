@@ -0,0 +1,35 @@
+/**
+* behave.c
+* Author: Gabriel Murphy
+* Date: Mon Oct 19 2026
+* Summary: Decides what a process does with the quantum it was granted
+*/
+#include "behave.h"
+#include "rng.h"
+
+/**
+* Randomly decides (using the probabilities and random stream in the pcb)
+* whether the process terminates, is interrupted by I/O, or uses its full
+* quantum. Sets the matching flag and returns the nanoseconds it ran for
+*/
+int runBurst(pcb_t *pcb, int quantum, bool *interrupt, bool *finished) {
+	*interrupt = false;
+	*finished = false;
+
+	// Check for termination using the termination probability
+	// 1 in termProb chance of terminating this cycle
+	if (randInt(&pcb->rng, pcb->termProb) == (pcb->termProb - 1)) {
+		*finished = true;
+		// How much of this quantum to use before terminating
+		return sampleBurst(&pcb->burst, &pcb->rng, quantum);
+	}
+
+	// Check for interrupt using the interrupt probability
+	if (randInt(&pcb->rng, pcb->intProb) == (pcb->intProb - 1)) {
+		*interrupt = true;
+		// How much of this quantum to use before the interrupt occurs
+		return sampleBurst(&pcb->burst, &pcb->rng, quantum);
+	}
+
+	return quantum;
+}
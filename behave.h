@@ -0,0 +1,15 @@
+/**
+* behave.h
+* Author: Gabriel Murphy
+* Date: Mon Oct 19 2026
+* Summary: Behaviour of a dispatched process, shared by Process and by
+* the inline mode of OSS where no child processes are forked
+*/
+#ifndef BEHAVE_H
+#define BEHAVE_H
+
+#include "oss.h"
+
+int runBurst(pcb_t *, int, bool *, bool *);
+
+#endif
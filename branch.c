@@ -0,0 +1,221 @@
+/**
+* branch.c
+* Author: Gabriel Murphy
+* Date: Mon Oct 19 2026
+* Summary: Forks what-if clones at the branch point and merges their results
+*/
+#define _GNU_SOURCE
+#include "branch.h"
+#include "quantum.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sched.h>
+#include <sys/wait.h>
+
+// Names of the parameters as used on the command line, indexed by param_t
+static const char *paramNames[] = {
+	"baseline", "quantumFactor", "numQueues", "agingThreshold", "maxIoWait"
+};
+
+/**
+* Parses a "name=v1,v2,..." spec and appends one variant per value
+* starting at variants[count]. Returns the new count, or -1 if invalid
+*/
+int parseVariants(char *spec, variant_t *variants, int count, int max) {
+	char *equals = strchr(spec, '=');
+	char *value, *end;
+	param_t param = PARAM_NONE;
+	int i;
+
+	if (equals == NULL) {
+		fprintf(stderr, "What-if spec '%s' must look like name=v1,v2,...\n", spec);
+		return -1;
+	}
+
+	for (i = PARAM_QUANTUM_FACTOR; i <= PARAM_MAX_IO_WAIT; i++) {
+		if (strncmp(spec, paramNames[i], equals - spec) == 0 
+				&& strlen(paramNames[i]) == (size_t) (equals - spec)) {
+			param = i;
+		}
+	}
+
+	if (param == PARAM_NONE) {
+		fprintf(stderr, "Unknown what-if parameter in '%s'\n", spec);
+		return -1;
+	}
+
+	value = equals + 1;
+
+	while (*value != '\0') {
+		if (count >= max) {
+			fprintf(stderr, "At most %d what-if variants are supported\n", max);
+			return -1;
+		}
+
+		variants[count].param = param;
+		variants[count].value = strtol(value, &end, 10);
+
+		// Ranges are checked against the preferences by checkVariants
+		if (end == value || (*end != ',' && *end != '\0')) {
+			fprintf(stderr, "Invalid value for %s in '%s'\n", paramNames[param], spec);
+			return -1;
+		}
+
+		count++;
+		value = (*end == ',') ? end + 1 : end;
+	}
+
+	return count;
+}
+
+/**
+* Changes the preference a variant is about, false if the value is out of range
+*/
+bool applyVariant(variant_t *variant, config_t *config) {
+	char value[16];
+
+	if (variant->param == PARAM_NONE) {
+		return true;
+	}
+
+	snprintf(value, sizeof(value), "%d", variant->value);
+
+	return setPref(config, paramNames[variant->param], value);
+}
+
+/**
+* Checks every variant can be applied to config and gives valid quantums,
+* before anything is forked
+*/
+bool checkVariants(variant_t *variants, int count, config_t *config) {
+	int quantums[PREF_LIST_LEN];
+	config_t copy;
+	int i;
+
+	for (i = 0; i < count; i++) {
+		copy = *config;
+
+		if (!applyVariant(&variants[i], &copy) || !validateConfig(&copy)
+				|| !buildQuantums(&copy, quantums)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+* Restricts the calling process to a single core
+*/
+static void pinToCore(int core) {
+	cpu_set_t set;
+
+	CPU_ZERO(&set);
+	CPU_SET(core, &set);
+
+	// Only a hint, clones still run correctly if pinning is not allowed
+	sched_setaffinity(0, sizeof(set), &set);
+}
+
+/**
+* Forks one clone per variant, each with a pipe back to the parent and
+* pinned to its own core (wrapping if there are more clones than cores).
+* Returns the index of the variant in the clone, -1 in the parent
+*/
+int forkVariants(variant_t *variants, int count) {
+	long cores = sysconf(_SC_NPROCESSORS_ONLN);
+	int fds[2];
+	int i;
+
+	// Flush so buffered output isn't written again by each clone
+	fflush(NULL);
+
+	for (i = 0; i < count; i++) {
+		if (pipe(fds) == -1) {
+			perror("OSS failed to create pipe for what-if clone");
+			variants[i].pid = -1;
+			continue;
+		}
+
+		variants[i].pid = fork();
+
+		// Clone does this
+		if (variants[i].pid == 0) {
+			close(fds[0]);
+			variants[i].fd = fds[1];
+
+			if (cores > 0) {
+				pinToCore(i % cores);
+			}
+
+			return i;
+		}
+
+		close(fds[1]);
+
+		if (variants[i].pid == -1) {
+			perror("OSS failed to fork what-if clone");
+			close(fds[0]);
+			continue;
+		}
+
+		variants[i].fd = fds[0];
+	}
+
+	return -1;
+}
+
+/**
+* Sends the results of a clone back to the parent
+*/
+bool sendResult(int fd, result_t *result) {
+	bool success = write(fd, result, sizeof(result_t)) == sizeof(result_t);
+
+	close(fd);
+
+	return success;
+}
+
+/**
+* Waits for every clone, then prints a table comparing their results
+*/
+void collectResults(variant_t *variants, int count) {
+	result_t result;
+	char name[64];
+	int i;
+
+	printf("%-24s %16s %16s %16s %9s %11s\n", "Variant", "CPU idle", 
+		"Average wait", "Average turn", "Finished", "Dispatches");
+
+	for (i = 0; i < count; i++) {
+		if (variants[i].param == PARAM_NONE) {
+			snprintf(name, sizeof(name), "%s", paramNames[PARAM_NONE]);
+		}
+		else {
+			snprintf(name, sizeof(name), "%s=%d", paramNames[variants[i].param], variants[i].value);
+		}
+
+		if (variants[i].pid == -1) {
+			printf("%-24s failed to start\n", name);
+			continue;
+		}
+
+		// A clone writes exactly one result just before it exits
+		if (read(variants[i].fd, &result, sizeof(result_t)) != sizeof(result_t)) {
+			printf("%-24s did not report results\n", name);
+		}
+		else {
+			printf("%-24s %6d.%09d %6d.%09d %6d.%09d %4d/%-4d %11lld\n", name,
+				result.cpuIdleTime.sec, result.cpuIdleTime.nnsec,
+				result.averageWait.sec, result.averageWait.nnsec,
+				result.averageTurn.sec, result.averageTurn.nnsec,
+				result.totalFinished, result.totalProcesses, result.dispatches);
+		}
+
+		close(variants[i].fd);
+		waitpid(variants[i].pid, NULL, 0);
+	}
+}
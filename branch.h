@@ -0,0 +1,58 @@
+/**
+* branch.h
+* Author: Gabriel Murphy
+* Date: Mon Oct 19 2026
+* Summary: What-if exploration. OSS simulates up to a branch point, then
+* forks one clone per variant, each continuing from the same state with one
+* policy parameter changed. Clones report back through pipes and the
+* results are merged into one comparison table
+*/
+#ifndef BRANCH_H
+#define BRANCH_H
+
+#include "oss.h"
+#include "config.h"
+#include <sys/types.h>
+
+// Max number of clones forked at the branch point (including baseline)
+#define MAX_VARIANTS 32
+
+// Policy parameters a clone can change
+typedef enum {
+	PARAM_NONE,
+	PARAM_QUANTUM_FACTOR,
+	PARAM_NUM_QUEUES,
+	PARAM_AGING,
+	PARAM_MAX_IO_WAIT
+} param_t;
+
+typedef struct variant_t {
+	param_t param;
+	int value;
+	pid_t pid;
+	int fd;
+} variant_t;
+
+// Statistics a clone sends back when it finishes
+typedef struct result_t {
+	stime_t cpuIdleTime;
+	stime_t averageWait;
+	stime_t averageTurn;
+	int totalProcesses;
+	int totalFinished;
+	long long dispatches;
+} result_t;
+
+int parseVariants(char *, variant_t *, int, int);
+
+bool applyVariant(variant_t *, config_t *);
+
+bool checkVariants(variant_t *, int, config_t *);
+
+int forkVariants(variant_t *, int);
+
+bool sendResult(int, result_t *);
+
+void collectResults(variant_t *, int);
+
+#endif
@@ -0,0 +1,140 @@
+/**
+* checkpoint.c
+* Author: Gabriel Murphy
+* Date: Mon Oct 19 2026
+* Summary: Writes and reads compact binary snapshots of the simulation.
+* A checkpoint holds the loop state of OSS, the simulated clock, the pcb
+* array (including each process's random stream) and the contents of
+* every priority queue.
+* Layout: magic, version, numProcess, numQueues, simstate_t, stime_t,
+* pcb_t[numProcess], then for each queue its size followed by its indices
+*/
+#include "checkpoint.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+* Writes count items of size bytes, returns false on a short write
+*/
+static bool writeItems(FILE *file, const void *data, size_t size, size_t count) {
+	return fwrite(data, size, count, file) == count;
+}
+
+/**
+* Reads count items of size bytes, returns false on a short read
+*/
+static bool readItems(FILE *file, void *data, size_t size, size_t count) {
+	return fread(data, size, count, file) == count;
+}
+
+/**
+* Saves the simulation to filename. Written to a temporary file first and
+* renamed, so an existing checkpoint is never left half written.
+* Returns false if the checkpoint could not be written
+*/
+bool saveCheckpoint(const char *filename, simstate_t *state, stime_t *clock,
+		pcb_t *pcb, int numProcess, queue_t *queues, int numQueues) {
+	FILE *file;
+	char tempName[256];
+	int version = CKPT_VERSION;
+	bool success;
+	int i;
+
+	snprintf(tempName, sizeof(tempName), "%s.tmp", filename);
+
+	if ((file = fopen(tempName, "wb")) == NULL) {
+		return false;
+	}
+
+	success = writeItems(file, CKPT_MAGIC, 1, strlen(CKPT_MAGIC))
+		&& writeItems(file, &version, sizeof(int), 1)
+		&& writeItems(file, &numProcess, sizeof(int), 1)
+		&& writeItems(file, &numQueues, sizeof(int), 1)
+		&& writeItems(file, state, sizeof(simstate_t), 1)
+		&& writeItems(file, clock, sizeof(stime_t), 1)
+		&& writeItems(file, pcb, sizeof(pcb_t), numProcess);
+
+	for (i = 0; success && i < numQueues; i++) {
+		node_t *current = queues[i].head;
+
+		success = writeItems(file, &queues[i].size, sizeof(int), 1);
+
+		while (success && current != NULL) {
+			success = writeItems(file, &current->index, sizeof(int), 1);
+			current = current->next;
+		}
+	}
+
+	if (fclose(file) != 0) {
+		success = false;
+	}
+
+	if (!success || rename(tempName, filename) == -1) {
+		remove(tempName);
+		return false;
+	}
+
+	return true;
+}
+
+/**
+* Restores a simulation saved by saveCheckpoint. The checkpoint must have
+* been taken with the same number of processes and queues.
+* queues must be empty. Returns false (with a message on stderr) on failure
+*/
+bool loadCheckpoint(const char *filename, simstate_t *state, stime_t *clock,
+		pcb_t *pcb, int numProcess, queue_t *queues, int numQueues) {
+	FILE *file;
+	char magic[sizeof(CKPT_MAGIC)] = {0};
+	int version, savedProcess, savedQueues;
+	int size, index;
+	bool success;
+	int i;
+
+	if ((file = fopen(filename, "rb")) == NULL) {
+		perror("Failed to open checkpoint file");
+		return false;
+	}
+
+	success = readItems(file, magic, 1, strlen(CKPT_MAGIC))
+		&& readItems(file, &version, sizeof(int), 1)
+		&& readItems(file, &savedProcess, sizeof(int), 1)
+		&& readItems(file, &savedQueues, sizeof(int), 1);
+
+	if (!success || strcmp(magic, CKPT_MAGIC) != 0 || version != CKPT_VERSION) {
+		fprintf(stderr, "%s is not a version %d checkpoint file\n", filename, CKPT_VERSION);
+		fclose(file);
+		return false;
+	}
+
+	if (savedProcess != numProcess || savedQueues != numQueues) {
+		fprintf(stderr, "Checkpoint was taken with %d processes and %d queues\n",
+			savedProcess, savedQueues);
+		fclose(file);
+		return false;
+	}
+
+	success = readItems(file, state, sizeof(simstate_t), 1)
+		&& readItems(file, clock, sizeof(stime_t), 1)
+		&& readItems(file, pcb, sizeof(pcb_t), numProcess);
+
+	for (i = 0; success && i < numQueues; i++) {
+		success = readItems(file, &size, sizeof(int), 1);
+
+		while (success && size-- > 0) {
+			success = readItems(file, &index, sizeof(int), 1) && index >= 0 && index < numProcess;
+			if (success) {
+				push(&queues[i], index);
+			}
+		}
+	}
+
+	fclose(file);
+
+	if (!success) {
+		fprintf(stderr, "Checkpoint file %s is truncated or corrupt\n", filename);
+	}
+
+	return success;
+}
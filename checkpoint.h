@@ -0,0 +1,45 @@
+/**
+* checkpoint.h
+* Author: Gabriel Murphy
+* Date: Mon Oct 19 2026
+* Summary: State of a running simulation that is not held in shared
+* memory, and functions to save/restore the full simulation to a file
+*/
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "oss.h"
+#include "queue.h"
+#include "config.h"
+
+// Identifies a checkpoint file, version bumped whenever the layout changes
+#define CKPT_MAGIC "MLFQCKPT"
+#define CKPT_VERSION 6
+
+// Everything the main loop of OSS carries between cycles
+typedef struct simstate_t {
+	rng_t rng;
+	source_t source;
+	stime_t generateTime;
+	stime_t checkpointTime;
+	stime_t cpuIdleTime;
+	stime_t totalWait;
+	stime_t totalTurn;
+	int totalProcesses;
+	int totalFinished;
+	int lineCount;
+	int lastDispatched;
+	long long dispatches;
+	long long overheadTime;
+	long long busyTime;
+	long long demotions;
+	// Children that died or hung and had their pcb reclaimed
+	long long faults;
+	long long allotmentsExhausted[PREF_LIST_LEN];
+} simstate_t;
+
+bool saveCheckpoint(const char *, simstate_t *, stime_t *, pcb_t *, int, queue_t *, int);
+
+bool loadCheckpoint(const char *, simstate_t *, stime_t *, pcb_t *, int, queue_t *, int);
+
+#endif
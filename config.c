@@ -0,0 +1,427 @@
+/**
+* config.c
+* Author: Gabriel Murphy
+* Date: Mon Oct 19 2026
+* Summary: Parsing, range checking and dumping of the simulation preferences.
+* Every preference is described once in prefTable, which drives all of them
+*/
+#include "config.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <ctype.h>
+#include <errno.h>
+#include <limits.h>
+
+typedef enum {
+	PREF_INT,
+	PREF_LONG,
+	PREF_DOUBLE,
+	PREF_STRING,
+	PREF_ENUM,
+	PREF_LIST
+} preftype_t;
+
+// Description of a single preference, min/max apply to numbers and
+// to every value of a list, names are the values of an enum
+typedef struct pref_t {
+	const char *key;
+	preftype_t type;
+	size_t offset;
+	long long min;
+	long long max;
+	const char *dflt;
+	const char *const *names;
+} pref_t;
+
+#define PREF(key, type, min, max, dflt) {#key, type, offsetof(config_t, key), min, max, dflt, NULL}
+#define PREF_NAMES(key, names, dflt) {#key, PREF_ENUM, offsetof(config_t, key), 0, 0, dflt, names}
+
+// Names of the values of enum preferences, NULL terminated
+static const char *const scheduleNames[] = {"geometric", "linear", "list", NULL};
+static const char *const distNames[] = {"uniform", "exponential", "pareto", "lognormal", NULL};
+
+static const pref_t prefTable[] = {
+	PREF(numProcess,         PREF_INT,    1, 18,         "16"),
+	PREF(numQueues,          PREF_INT,    1, 16,         "6"),
+	PREF(waitReal,           PREF_INT,    1, INT_MAX,    "120"),
+	PREF(waitSim,            PREF_INT,    1, INT_MAX,    "2"),
+	PREF_NAMES(arrivalDist,  distNames,              "uniform"),
+	PREF(generateRate,       PREF_INT,    1, INT_MAX,    "5000000"),
+	PREF(arrivalShape,       PREF_DOUBLE, 0, 100,        "1.5"),
+	PREF(onMean,             PREF_INT,    0, INT_MAX,    "0"),
+	PREF(offMean,            PREF_INT,    0, INT_MAX,    "0"),
+	PREF(quantumFactor,      PREF_INT,    1, INT_MAX,    "100000"),
+	PREF_NAMES(quantumSchedule, scheduleNames,   "geometric"),
+	PREF(quantumList,        PREF_LIST,   1, INT_MAX,    ""),
+	PREF(workMax,            PREF_INT,    1, 20000000,   "10000"),
+	PREF(switchCost,         PREF_INT,    0, 100000000,  "0"),
+	PREF(levelSwitchCost,    PREF_INT,    0, 10000000,   "0"),
+	PREF(cachePenalty,       PREF_INT,    0, 100000000,  "0"),
+	PREF(cacheDecay,         PREF_INT,    0, INT_MAX,    "1000000"),
+	PREF(maxLines,           PREF_INT,    0, INT_MAX,    "10000"),
+	PREF(intMin,             PREF_INT,    1, INT_MAX,    "4"),
+	PREF(intMax,             PREF_INT,    1, INT_MAX,    "12"),
+	PREF(termMin,            PREF_INT,    1, INT_MAX,    "12"),
+	PREF(termMax,            PREF_INT,    1, INT_MAX,    "26"),
+	PREF_NAMES(burstDist,    distNames,              "uniform"),
+	PREF(burstScale,         PREF_INT,    1, INT_MAX,    "100000"),
+	PREF(burstShape,         PREF_DOUBLE, 0, 100,        "1.0"),
+	PREF(batchPercent,       PREF_INT,    0, 100,        "0"),
+	PREF(batchIntMin,        PREF_INT,    1, INT_MAX,    "20"),
+	PREF(batchIntMax,        PREF_INT,    1, INT_MAX,    "40"),
+	PREF(batchTermMin,       PREF_INT,    1, INT_MAX,    "30"),
+	PREF(batchTermMax,       PREF_INT,    1, INT_MAX,    "60"),
+	PREF_NAMES(batchBurstDist, distNames,            "uniform"),
+	PREF(batchBurstScale,    PREF_INT,    1, INT_MAX,    "1000000"),
+	PREF(batchBurstShape,    PREF_DOUBLE, 0, 100,        "1.0"),
+	PREF(sleepAmount,        PREF_INT,    0, INT_MAX,    "300000"),
+	PREF(maxFps,             PREF_INT,    0, 1000,       "30"),
+	PREF(maxIoWait,          PREF_INT,    1, INT_MAX,    "1000000"),
+	PREF(checkpointInterval, PREF_INT,    0, INT_MAX,    "0"),
+	PREF(agingThreshold,     PREF_INT,    0, INT_MAX,    "0"),
+	PREF(allotmentFactor,    PREF_INT,    0, 1000,       "0"),
+	PREF(replyTimeout,       PREF_INT,    1, 3600000,    "1000"),
+	PREF(seed,               PREF_LONG,   0, LLONG_MAX,  "0"),
+	PREF(logFile,            PREF_STRING, 0, 0,          "test.out"),
+	PREF(checkpointFile,     PREF_STRING, 0, 0,          "oss.ckpt")
+};
+
+#define NUM_PREFS (sizeof(prefTable) / sizeof(pref_t))
+
+/**
+* Finds the description of a preference by key, NULL if there is none
+*/
+static const pref_t *findPref(const char *key) {
+	size_t i;
+
+	for (i = 0; i < NUM_PREFS; i++) {
+		if (strcmp(prefTable[i].key, key) == 0) {
+			return &prefTable[i];
+		}
+	}
+
+	return NULL;
+}
+
+/**
+* Parses an integer that must fill all of value and be in the pref's range
+* Returns false (with a message on stderr) if it isn't
+*/
+static bool parseNumber(const pref_t *pref, const char *value, long long *number) {
+	char *end;
+
+	errno = 0;
+	*number = strtoll(value, &end, 10);
+
+	if (errno != 0 || end == value || *end != '\0') {
+		fprintf(stderr, "Preference %s must be an integer, not '%s'\n", pref->key, value);
+		return false;
+	}
+
+	if (*number < pref->min || *number > pref->max) {
+		fprintf(stderr, "Preference %s must be between %lld and %lld, not %lld\n",
+			pref->key, pref->min, pref->max, *number);
+		return false;
+	}
+
+	return true;
+}
+
+/**
+* Parses a decimal number that must fill all of value and be in the pref's range
+*/
+static bool parseDouble(const pref_t *pref, const char *value, double *number) {
+	char *end;
+
+	errno = 0;
+	*number = strtod(value, &end);
+
+	if (errno != 0 || end == value || *end != '\0') {
+		fprintf(stderr, "Preference %s must be a number, not '%s'\n", pref->key, value);
+		return false;
+	}
+
+	if (*number < pref->min || *number > pref->max) {
+		fprintf(stderr, "Preference %s must be between %lld and %lld, not %g\n",
+			pref->key, pref->min, pref->max, *number);
+		return false;
+	}
+
+	return true;
+}
+
+/**
+* Parses a comma separated list of integers, an empty value is an empty list
+*/
+static bool parseList(const pref_t *pref, const char *value, intlist_t *list) {
+	char buff[PREF_STR_LEN];
+	char *item, *savePtr;
+	long long number;
+	intlist_t result = {0};
+
+	snprintf(buff, sizeof(buff), "%s", value);
+
+	for (item = strtok_r(buff, ", ", &savePtr); item != NULL; item = strtok_r(NULL, ", ", &savePtr)) {
+		if (result.count == PREF_LIST_LEN) {
+			fprintf(stderr, "Preference %s can have at most %d values\n", pref->key, PREF_LIST_LEN);
+			return false;
+		}
+
+		if (!parseNumber(pref, item, &number)) {
+			return false;
+		}
+
+		result.values[result.count++] = (int) number;
+	}
+
+	*list = result;
+
+	return true;
+}
+
+/**
+* Sets a single preference from its text value, checking type and range
+* Returns false (with a message on stderr) if key or value is invalid
+*/
+bool setPref(config_t *config, const char *key, const char *value) {
+	const pref_t *pref = findPref(key);
+	char *field;
+	long long number;
+	int i;
+
+	if (pref == NULL) {
+		fprintf(stderr, "Unknown preference '%s'\n", key);
+		return false;
+	}
+
+	field = (char *) config + pref->offset;
+
+	if (pref->type == PREF_STRING) {
+		if (strlen(value) == 0 || strlen(value) >= PREF_STR_LEN) {
+			fprintf(stderr, "Preference %s must be 1 to %d characters\n", key, PREF_STR_LEN - 1);
+			return false;
+		}
+
+		strcpy(field, value);
+		return true;
+	}
+
+	if (pref->type == PREF_ENUM) {
+		for (i = 0; pref->names[i] != NULL; i++) {
+			if (strcmp(pref->names[i], value) == 0) {
+				*(int *) field = i;
+				return true;
+			}
+		}
+
+		fprintf(stderr, "Preference %s can't be '%s', must be one of:", key, value);
+		for (i = 0; pref->names[i] != NULL; i++) {
+			fprintf(stderr, " %s", pref->names[i]);
+		}
+		fprintf(stderr, "\n");
+		return false;
+	}
+
+	if (pref->type == PREF_LIST) {
+		return parseList(pref, value, (intlist_t *) field);
+	}
+
+	if (pref->type == PREF_DOUBLE) {
+		return parseDouble(pref, value, (double *) field);
+	}
+
+	if (!parseNumber(pref, value, &number)) {
+		return false;
+	}
+
+	if (pref->type == PREF_INT) {
+		*(int *) field = (int) number;
+	}
+	else {
+		*(long long *) field = number;
+	}
+
+	return true;
+}
+
+/**
+* Fills in every preference with its default value
+*/
+void defaultConfig(config_t *config) {
+	size_t i;
+
+	memset(config, 0, sizeof(config_t));
+
+	for (i = 0; i < NUM_PREFS; i++) {
+		setPref(config, prefTable[i].key, prefTable[i].dflt);
+	}
+}
+
+/**
+* Removes leading and trailing whitespace in place, returns the new start
+*/
+static char *trim(char *text) {
+	char *end;
+
+	while (isspace((unsigned char) *text)) {
+		text++;
+	}
+
+	end = text + strlen(text);
+
+	while (end > text && isspace((unsigned char) end[-1])) {
+		end--;
+	}
+
+	*end = '\0';
+
+	return text;
+}
+
+/**
+* Applies a "key=value" assignment, as given to --set
+*/
+bool setConfig(config_t *config, const char *assignment) {
+	char buff[PREF_STR_LEN * 2];
+	char *equals;
+
+	snprintf(buff, sizeof(buff), "%s", assignment);
+
+	if ((equals = strchr(buff, '=')) == NULL) {
+		fprintf(stderr, "Preference override '%s' must look like key=value\n", assignment);
+		return false;
+	}
+
+	*equals = '\0';
+
+	return setPref(config, trim(buff), trim(equals + 1));
+}
+
+/**
+* Reads a file of "key = value" lines into config. Blank lines and
+* everything after a '#' are ignored. Keys not in the file are unchanged,
+* so several files can be layered. Returns false on any invalid line
+*/
+bool loadConfig(config_t *config, const char *filename) {
+	FILE *file;
+	char buff[PREF_STR_LEN * 2];
+	char *line, *comment;
+	int lineNum = 0;
+	bool success = true;
+
+	if ((file = fopen(filename, "r")) == NULL) {
+		fprintf(stderr, "Failed to open pref file %s: %s\n", filename, strerror(errno));
+		return false;
+	}
+
+	while (fgets(buff, sizeof(buff), file) != NULL) {
+		lineNum++;
+
+		if ((comment = strchr(buff, '#')) != NULL) {
+			*comment = '\0';
+		}
+
+		line = trim(buff);
+
+		if (*line == '\0') {
+			continue;
+		}
+
+		if (!setConfig(config, line)) {
+			fprintf(stderr, "  in %s line %d\n", filename, lineNum);
+			success = false;
+		}
+	}
+
+	fclose(file);
+
+	return success;
+}
+
+/**
+* Checks rules between preferences that a single range can't express
+*/
+bool validateConfig(config_t *config) {
+	bool success = true;
+
+	if (config->intMin > config->intMax) {
+		fprintf(stderr, "Preference intMin (%d) is greater than intMax (%d)\n",
+			config->intMin, config->intMax);
+		success = false;
+	}
+
+	if (config->termMin > config->termMax) {
+		fprintf(stderr, "Preference termMin (%d) is greater than termMax (%d)\n",
+			config->termMin, config->termMax);
+		success = false;
+	}
+
+	if (config->batchIntMin > config->batchIntMax || config->batchTermMin > config->batchTermMax) {
+		fprintf(stderr, "Preferences batchIntMin/batchTermMin are greater than their max\n");
+		success = false;
+	}
+
+	if ((config->arrivalDist == DIST_PARETO && config->arrivalShape <= 0)
+			|| (config->burstDist == DIST_PARETO && config->burstShape <= 0)
+			|| (config->batchBurstDist == DIST_PARETO && config->batchBurstShape <= 0)) {
+		fprintf(stderr, "Pareto distributions need a shape greater than 0\n");
+		success = false;
+	}
+
+	if (config->quantumSchedule == SCHEDULE_LIST && config->quantumList.count < config->numQueues) {
+		fprintf(stderr, "Preference quantumList has %d values, one per queue (%d) is needed\n",
+			config->quantumList.count, config->numQueues);
+		success = false;
+	}
+
+	return success;
+}
+
+/**
+* Writes a list preference as comma separated values
+*/
+static void dumpList(FILE *file, intlist_t *list) {
+	int i;
+
+	for (i = 0; i < list->count; i++) {
+		fprintf(file, (i == 0) ? "%d" : ",%d", list->values[i]);
+	}
+
+	fprintf(file, "\n");
+}
+
+/**
+* Writes every preference as "key = value", each line starting with prefix
+* The output can be read back in by loadConfig
+*/
+void dumpConfig(config_t *config, FILE *file, const char *prefix) {
+	size_t i;
+
+	for (i = 0; i < NUM_PREFS; i++) {
+		char *field = (char *) config + prefTable[i].offset;
+
+		fprintf(file, "%s%s = ", prefix, prefTable[i].key);
+
+		switch (prefTable[i].type) {
+			case PREF_INT:
+				fprintf(file, "%d\n", *(int *) field);
+				break;
+			case PREF_LONG:
+				fprintf(file, "%lld\n", *(long long *) field);
+				break;
+			case PREF_DOUBLE:
+				fprintf(file, "%g\n", *(double *) field);
+				break;
+			case PREF_STRING:
+				fprintf(file, "%s\n", field);
+				break;
+			case PREF_ENUM:
+				fprintf(file, "%s\n", prefTable[i].names[*(int *) field]);
+				break;
+			case PREF_LIST:
+				dumpList(file, (intlist_t *) field);
+				break;
+		}
+	}
+}
@@ -0,0 +1,93 @@
+/**
+* config.h
+* Author: Gabriel Murphy
+* Date: Mon Oct 19 2026
+* Summary: Simulation preferences. Read from keyed "key = value" files
+* (pref.dat by default), overridable one key at a time from the command line
+*/
+#ifndef CONFIG_H
+#define CONFIG_H
+
+#include "oss.h"
+#include <stdio.h>
+
+#define DFLT_PREFS "pref.dat"
+
+// Max length of string preferences (file names)
+#define PREF_STR_LEN 256
+
+// Max number of values in a list preference, also the max number of queues
+#define PREF_LIST_LEN 16
+
+// How the quantum of each queue is calculated from quantumFactor
+typedef enum {
+	SCHEDULE_GEOMETRIC,
+	SCHEDULE_LINEAR,
+	SCHEDULE_LIST
+} schedule_t;
+
+// Comma separated list of integers, e.g. "1,2,3"
+typedef struct intlist_t {
+	int count;
+	int values[PREF_LIST_LEN];
+} intlist_t;
+
+typedef struct config_t {
+	int numProcess;
+	int numQueues;
+	int waitReal;
+	int waitSim;
+	int arrivalDist;
+	int generateRate;
+	double arrivalShape;
+	int onMean;
+	int offMean;
+	int quantumFactor;
+	int quantumSchedule;
+	intlist_t quantumList;
+	int workMax;
+	int switchCost;
+	int levelSwitchCost;
+	int cachePenalty;
+	int cacheDecay;
+	int maxLines;
+	int intMin;
+	int intMax;
+	int termMin;
+	int termMax;
+	int burstDist;
+	int burstScale;
+	double burstShape;
+	int batchPercent;
+	int batchIntMin;
+	int batchIntMax;
+	int batchTermMin;
+	int batchTermMax;
+	int batchBurstDist;
+	int batchBurstScale;
+	double batchBurstShape;
+	int sleepAmount;
+	int maxFps;
+	int maxIoWait;
+	int checkpointInterval;
+	int agingThreshold;
+	int allotmentFactor;
+	int replyTimeout;
+	long long seed;
+	char logFile[PREF_STR_LEN];
+	char checkpointFile[PREF_STR_LEN];
+} config_t;
+
+void defaultConfig(config_t *);
+
+bool loadConfig(config_t *, const char *);
+
+bool setConfig(config_t *, const char *);
+
+bool setPref(config_t *, const char *, const char *);
+
+bool validateConfig(config_t *);
+
+void dumpConfig(config_t *, FILE *, const char *);
+
+#endif
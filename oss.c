@@ -9,8 +9,15 @@
 * processes, prints the status of the system each cycle, and handles the
 * end of the of the simulation.
 */
+#define _GNU_SOURCE
 #include "oss.h"
 #include "queue.h"
+#include "checkpoint.h"
+#include "behave.h"
+#include "branch.h"
+#include "config.h"
+#include "quantum.h"
+#include "render.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -18,12 +25,16 @@
 #include <time.h>
 #include <signal.h>
 #include <errno.h>
+#include <getopt.h>
+#include <math.h>
 #include <sys/ipc.h>
 #include <sys/shm.h>
 #include <sys/msg.h>
 #include <sys/wait.h>
+#include <sys/signalfd.h>
+#include <sys/syscall.h>
+#include <poll.h>
 
-#define DFLT_FILEN "test.out"
 
 // Shared memory vars, need to be global for signal handling purposes
 stime_t *g_stime;
@@ -37,6 +48,17 @@ int g_mossId;
 
 FILE *g_output;
 
+// Supervision of children: pidfd of each pcb's child (-1 if none or
+// unsupported) and a signalfd that becomes readable when a child exits
+int *g_pidfd;
+int g_sigFd = -1;
+
+// Inline mode simulates Process inside OSS, no children or shared memory
+bool g_inline = false;
+
+// Set by SIGUSR1, main loop writes a checkpoint when it sees this
+volatile sig_atomic_t g_checkpointRequested = 0;
+
 /**
 * Detatches pointer from shared mem and marks the segment for removal
 * Returns false if either op fails, true if both successful
@@ -59,7 +81,24 @@ bool cleanMsgQueue(int id) {
 */
 void cleanUp() {
 	bool success = true;
-	fclose(g_output);
+
+	// Log is only opened once setup has succeeded
+	if (g_output != NULL) {
+		fclose(g_output);
+	}
+
+	if (g_sigFd != -1) {
+		close(g_sigFd);
+	}
+
+	free(g_pidfd);
+
+	// Inline mode uses private memory and no message queues
+	if (g_inline) {
+		free(g_stime);
+		free(g_pcb);
+		return;
+	}
 
 	if (!cleanSegment(g_stime, g_stimeId) || !cleanSegment(g_pcb, g_pcbId)) {
 		fprintf(stderr, 
@@ -79,10 +118,43 @@ void cleanUp() {
 	}
 }
 
+/**
+* Allocate private memory for the clock and pcb array, used in inline mode
+*/
+void setupPrivateMemory(int numProcess) {
+	int i;
+
+	if ((g_stime = calloc(1, sizeof(stime_t))) == NULL 
+			|| (g_pcb = calloc(numProcess, sizeof(pcb_t))) == NULL) {
+		perror("Allocating memory failed in OSS");
+		exit(EXIT_FAILURE);
+	}
+
+	for (i = 0; i < numProcess; i++) {
+		g_pcb[i].id = -1;
+	}
+}
+
 /**
 * Allocate and link to shared memory segments
 */
 void setupMemory(int numProcess) {
+	int i;
+
+	if (g_inline) {
+		setupPrivateMemory(numProcess);
+		return;
+	}
+
+	if ((g_pidfd = calloc(numProcess, sizeof(int))) == NULL) {
+		perror("Allocating memory failed in OSS");
+		exit(EXIT_FAILURE);
+	}
+
+	for (i = 0; i < numProcess; i++) {
+		g_pidfd[i] = -1;
+	}
+
 	// Allocate segment of shared memory
 	if ((g_stimeId = shmget(STM_KEY, sizeof(stime_t), IPC_CREAT | 0660)) < 0) {
 		perror("Allocating shared memory failed in OSS");
@@ -117,8 +189,6 @@ void setupMemory(int numProcess) {
 	// Initialize shared nanoseconds to 0
 	g_stime->nnsec = 0;
 
-	int i;
-
 	for (i = 0; i < numProcess; i++) {
 		g_pcb[i].id = -1;
 	}
@@ -140,9 +210,13 @@ void setupMemory(int numProcess) {
 
 /**
 * Handles SIGINT ^C, waits for children then cleans up exits
+* Handles SIGUSR1 by flagging that a checkpoint should be written
 */
 void sigHandler(int sig) {
-	if (sig == SIGINT) {
+	if (sig == SIGUSR1) {
+		g_checkpointRequested = 1;
+	}
+	else if (sig == SIGINT) {
 		// Wait for child processess to handle interrupt
 		while (wait(NULL) > 0);
 		// Clean up actions on shared memory
@@ -153,30 +227,138 @@ void sigHandler(int sig) {
 }
 
 /**
-* Kills all child processes using their ids in the pcb
+* Blocks SIGCHLD and creates a signalfd for it, so child exits can be
+* checked for in the main loop without a signal handler
+*/
+void setupChildEvents() {
+	sigset_t mask;
+
+	sigemptyset(&mask);
+	sigaddset(&mask, SIGCHLD);
+
+	if (sigprocmask(SIG_BLOCK, &mask, NULL) == -1 
+			|| (g_sigFd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC)) == -1) {
+		perror("OSS failed to set up child exit events");
+		cleanUp();
+		exit(EXIT_FAILURE);
+	}
+}
+
+/**
+* Opens a pidfd for a child, which becomes readable when it exits
+* Returns -1 if the kernel doesn't support pidfds
+*/
+int pidfdOpen(pid_t pid) {
+#ifdef SYS_pidfd_open
+	return syscall(SYS_pidfd_open, pid, 0);
+#else
+	errno = ENOSYS;
+	return -1;
+#endif
+}
+
+/**
+* Monotonic time in nanoseconds, for timeouts that mustn't jump with the clock
+*/
+long long monotonicTime() {
+	struct timespec timeSpec;
+
+	clock_gettime(CLOCK_MONOTONIC, &timeSpec);
+
+	return ((long long) timeSpec.tv_sec * NS_PER_S + (long long) timeSpec.tv_nsec);
+}
+
+/**
+* Kills all child processes using their ids in the pcb. Children get a
+* second to exit on SIGABRT, any still running after that are killed
 */
 void abortAll(int numProcess) {
+	long long deadline = monotonicTime() + NS_PER_S;
+	pid_t pid = 0;
 	int i;
 
+	// Inline ids are not real pids
+	if (g_inline) {
+		return;
+	}
+
 	for (i = 0; i < numProcess; i++) {
 		if (g_pcb[i].exists) {
-			kill(g_pcb[i].id, SIGABRT);
+			fprintf(stderr, "DBG abort %d\n", g_pcb[i].id); kill(g_pcb[i].id, SIGABRT);
+		}
+	}
+
+	while (monotonicTime() < deadline) {
+		while ((pid = waitpid(-1, NULL, WNOHANG)) > 0);
+
+		// No children left
+		if (pid == -1) {
+			return;
+		}
+
+		usleep(10000);
+	}
+
+	for (i = 0; i < numProcess; i++) {
+		if (g_pcb[i].exists) {
+			kill(g_pcb[i].id, SIGKILL);
 		}
 	}
 
 	while (wait(NULL) > 0);
 }
 
+/**
+* Forks/execs Process for an already set up pcb entry
+*/
+void spawnProcess(int numProcess, int index) {
+	pid_t thisPid;
+
+	thisPid = fork();
+
+	// Child does this
+	if (thisPid == 0) {
+		// index in the pcb array is sent to Process
+		char indexArg[8];
+		char procArg[8];
+		sigset_t mask;
+
+		// OSS blocks SIGCHLD for its signalfd, Process shouldn't inherit that
+		sigemptyset(&mask);
+		sigprocmask(SIG_SETMASK, &mask, NULL);
+
+		snprintf(indexArg, 8, "%d", index);
+		snprintf(procArg, 8, "%d", numProcess);
+
+		// Exec Process from child
+		execl("./Process", indexArg, procArg, NULL);
+
+		// Should never reach here
+		fprintf(stderr, "Failed to exec Process %d: %s", thisPid, strerror(errno));
+		exit(EXIT_FAILURE);
+	}
+	// Parent does this
+	else {
+		g_pcb[index].id = thisPid;
+
+		if (g_pidfd[index] != -1) {
+			close(g_pidfd[index]);
+		}
+
+		g_pidfd[index] = pidfdOpen(thisPid);
+	}
+}
+
 /**
 * Creates a new pcb entry and forks/execs new process
+* In inline mode no process is forked and the pcb is given id instead
+* The process is interactive or batch following the workload mix
 */
-void generateChild(int numProcess, int index, int intMin, int intMax, int termMin, int termMax) {
+void generateChild(rng_t *rng, config_t *config, int index, int id) {
 	struct pcb_t pcb;
-	pid_t thisPid;
-	int intProb, termProb;
 
 	// Make sure previous child occupying this pcb spot has fully terminated
-	if (g_pcb[index].id != -1) {
+	if (!g_inline && g_pcb[index].id != -1) {
 		waitpid(g_pcb[index].id, NULL, 0);
 	}
 
@@ -187,41 +369,65 @@ void generateChild(int numProcess, int index, int intMin, int intMax, int termMi
 	pcb.startTime = *g_stime;
 	
 	pcb.priority = 0;
+	pcb.levelUsed = 0;
+	pcb.lastRunTime = -1;
 	pcb.lastBurst = 0;
 	pcb.sysWaitTime.sec = 0;
 	pcb.sysWaitTime.nnsec = 0;
 
-	g_pcb[index] = pcb;
+	// Only draw a class if there is a mix, so all interactive runs are unchanged
+	pcb.class = (config->batchPercent > 0 && randInt(rng, 100) < config->batchPercent)
+		? CLASS_BATCH : CLASS_INTERACTIVE;
 
-	intProb = (rand() % (intMax + 1 - intMin)) + intMin;
-	termProb = (rand() % (termMax + 1 - termMin)) + termMin;
+	if (pcb.class == CLASS_BATCH) {
+		pcb.intProb = randInt(rng, config->batchIntMax + 1 - config->batchIntMin) + config->batchIntMin;
+		pcb.termProb = randInt(rng, config->batchTermMax + 1 - config->batchTermMin) + config->batchTermMin;
+		pcb.burst.type = config->batchBurstDist;
+		pcb.burst.scale = config->batchBurstScale;
+		pcb.burst.shape = config->batchBurstShape;
+	}
+	else {
+		pcb.intProb = randInt(rng, config->intMax + 1 - config->intMin) + config->intMin;
+		pcb.termProb = randInt(rng, config->termMax + 1 - config->termMin) + config->termMin;
+		pcb.burst.type = config->burstDist;
+		pcb.burst.scale = config->burstScale;
+		pcb.burst.shape = config->burstShape;
+	}
 
-	// Fork and exec new process
+	// Each process gets its own random stream derived from OSS's
+	seedRng(&pcb.rng, ((unsigned long long) nextRand(rng) << 31) ^ nextRand(rng));
 
-	thisPid = fork();
+	g_pcb[index] = pcb;
 
-	// Child does this
-	if (thisPid == 0) {
-		// index in the pcb array is sent to Process
-		char indexArg[8];
-		char procArg[8];
-		char intProbArg[8];
-		char termProbArg[8];
-		snprintf(indexArg, 8, "%d", index);
-		snprintf(procArg, 8, "%d", numProcess);
-		snprintf(intProbArg, 8, "%d", intProb);
-		snprintf(termProbArg, 8, "%d", termProb);
+	if (g_inline) {
+		g_pcb[index].id = id;
+		return;
+	}
 
-		// Exec Process from child
-		execl("./Process", indexArg, procArg, intProbArg, termProbArg, NULL);
+	// Fork and exec new process
+	spawnProcess(config->numProcess, index);
+}
 
-		// Should never reach here
-		fprintf(stderr, "Failed to exec Process %d: %s", thisPid, strerror(errno));
-		exit(EXIT_FAILURE);
+/**
+* Recreates the children of a restored checkpoint. Entries that are in
+* use get a fresh Process, ids of free entries are from the old run
+* and must not be waited on
+*/
+void respawnAll(int numProcess) {
+	int i;
+
+	// Inline processes have no child to recreate
+	if (g_inline) {
+		return;
 	}
-	// Parent does this
-	else {
-		g_pcb[index].id = thisPid;
+
+	for (i = 0; i < numProcess; i++) {
+		if (g_pcb[i].exists) {
+			spawnProcess(numProcess, i);
+		}
+		else {
+			g_pcb[i].id = -1;
+		}
 	}
 }
 
@@ -249,120 +455,322 @@ long long realTimeSinceEpoch() {
 }
 
 /**
-* Power function, returns base**exp
-* Unlike math.h pow, is integer based
+* Puts a process at the back of the queue for the given level
+* and remembers when, for aging
 */
-int intPow(int base, unsigned int exp) {
-	int i;
-	int result = 1;
+void enqueue(queue_t *queues, int level, int index) {
+	g_pcb[index].priority = level;
+	g_pcb[index].queuedTime = *g_stime;
+
+	push(&queues[level], index);
+}
+
+/**
+* Checks if a queued process has waited at least threshold nanoseconds
+*/
+bool agedOut(int index, int threshold) {
+	return combined(g_stime) - combined(&g_pcb[index].queuedTime) >= threshold;
+}
 
-	for (i = 0; i < base; i++) {
-		result *= base;
+/**
+* Simulated cost of switching the cpu to a process: a fixed context switch
+* cost, an extra cost per queue level, and a cache penalty that grows as
+* the cache cools down since the process last ran (a process that has never
+* run starts fully cold). Running the same process again costs nothing
+*/
+long long dispatchOverhead(config_t *config, int pcbIndex, int lastIndex) {
+	long long overhead;
+	double sinceRun;
+
+	if (pcbIndex == lastIndex) {
+		return 0;
 	}
 
-	return result;
+	overhead = config->switchCost + (long long) config->levelSwitchCost * g_pcb[pcbIndex].priority;
+
+	if (config->cachePenalty > 0) {
+		if (g_pcb[pcbIndex].lastRunTime < 0 || config->cacheDecay == 0) {
+			overhead += config->cachePenalty;
+		}
+		else {
+			// Warmth decays exponentially with the time since it last ran
+			sinceRun = combined(g_stime) - g_pcb[pcbIndex].lastRunTime;
+			overhead += (long long) (config->cachePenalty * (1 - exp(-sinceRun / config->cacheDecay)));
+		}
+	}
+
+	return overhead;
 }
 
 /**
-* Reads the preference variables from a file and adds them to an array
+* Checks if the child of a pcb has exited. Uses the result of the last
+* poll of its pidfd, or without one reaps it if it has
 */
-void readPreferences(int *prefs) {
-	FILE *file;
-	char *filename = "pref.dat";
-	int count = 0;
-	int i = 0;
-	char buff[128];
+bool childExited(int pcbIndex, struct pollfd *pidPoll) {
+	if (g_pidfd[pcbIndex] != -1) {
+		return (pidPoll->revents & (POLLIN | POLLHUP)) != 0;
+	}
 
-	if ((file = fopen(filename, "r")) == NULL) {
-		perror("Failed to open pref file in OSS");
-		exit(EXIT_FAILURE);
+	return waitpid(g_pcb[pcbIndex].id, NULL, WNOHANG) == g_pcb[pcbIndex].id;
+}
+
+/**
+* Waits for the reply of a dispatched child without blocking forever.
+* Polls the reply channel, sleeping on the child's pidfd in between with
+* a backoff from 10 microseconds up to a millisecond, so a fast reply is
+* picked up quickly and a dead child is noticed at once.
+* Replies left behind by children that timed out earlier are discarded
+*/
+reply_t waitReply(int pcbIndex, struct oss_msgbuf *ossBuf, int timeoutMs) {
+	long long deadline = monotonicTime() + timeoutMs * 1000000LL;
+	struct timespec backoff = {0, 10000};
+	struct pollfd pidPoll = {g_pidfd[pcbIndex], POLLIN, 0};
+
+	while (1) {
+		if (msgrcv(g_mossId, ossBuf, sizeof(struct oss_msgbuf) - sizeof(long), 1, IPC_NOWAIT) != -1) {
+			if (ossBuf->index == pcbIndex) {
+				return REPLY_OK;
+			}
+			continue;
+		}
+
+		if (errno != ENOMSG && errno != EINTR) {
+			perror("OSS failed to receive return message");
+			cleanUp();
+			exit(EXIT_FAILURE);
+		}
+
+		// A finishing child replies before it exits, so check once more
+		if (childExited(pcbIndex, &pidPoll)) {
+			if (msgrcv(g_mossId, ossBuf, sizeof(struct oss_msgbuf) - sizeof(long), 1, IPC_NOWAIT) != -1
+					&& ossBuf->index == pcbIndex) {
+				return REPLY_OK;
+			}
+			return REPLY_DEAD;
+		}
+
+		if (monotonicTime() >= deadline) {
+			return REPLY_HUNG;
+		}
+
+		ppoll(&pidPoll, 1, &backoff, NULL);
+
+		if (backoff.tv_nsec < 1000000) {
+			backoff.tv_nsec *= 2;
+		}
+	}
+}
+
+/**
+* Runs a process for a quantum, filling in ossBuf with what it did.
+* Schedules the child and waits for its reply, or in inline mode
+* decides the outcome directly. Returns whether the child replied
+*/
+reply_t dispatchProcess(int pcbIndex, int quantum, struct oss_msgbuf *ossBuf, int timeoutMs) {
+	struct sch_msgbuf schBuf;
+
+	if (g_inline) {
+		ossBuf->index = pcbIndex;
+		g_pcb[pcbIndex].lastBurst = 
+			runBurst(&g_pcb[pcbIndex], quantum, &ossBuf->interrupt, &ossBuf->finished);
+		return REPLY_OK;
 	}
 
-	while (fgets(buff, sizeof(buff), file) != NULL) {
-		// Numbers are every other line of file (others are descriptions)
-		if ((count % 2) != 0) {
-			prefs[i] = strtol(buff, NULL, 10);
-			i++;
+	// Message type is set to child pid, child only waits for this type
+	schBuf.mtype = g_pcb[pcbIndex].id;
+	schBuf.quantum = quantum;
+
+	// Send message to child proccess (msg type is child pid) to schedule 
+	// SysV message calls are never restarted, so retry if a signal interrupted
+	while (msgsnd(g_mschId, &schBuf, sizeof(struct sch_msgbuf) - sizeof(long), 0) == -1) {
+		if (errno == EINTR) {
+			continue;
 		}
 
-		count++;
+		perror("OSS failed to send sch messege");
+		cleanUp();
+		exit(EXIT_FAILURE);
 	}
 
-	fclose(file);
+	// Wait for return message from child process
+	return waitReply(pcbIndex, ossBuf, timeoutMs);
 }
 
 /**
-* Clears terminal and prints the status of the system
+* Frees the pcb of a child that died or hung, logging the fault.
+* A hung child is killed, the exit is reaped by reapChildren later.
+* Removes it from its queue and any schedule message it never read
 */
-void printStatus(int pcbIndex, int numProcess, int numQueues, queue_t *queues) {
+void reclaimPcb(int index, queue_t *queues, simstate_t *state, config_t *config, bool hung) {
+	struct sch_msgbuf schBuf;
+	char logBuff[128];
+
+	snprintf(logBuff, 128, "!! OSS: Process with PID %d %s at time %d.%d, reclaiming its pcb\n",
+		g_pcb[index].id, hung ? "stopped responding" : "died", g_stime->sec, g_stime->nnsec);
+	writeToLog(logBuff, &state->lineCount, config->maxLines);
+
+	if (hung) {
+		kill(g_pcb[index].id, SIGKILL);
+	}
+
+	while (msgrcv(g_mschId, &schBuf, sizeof(struct sch_msgbuf) - sizeof(long), g_pcb[index].id, IPC_NOWAIT) != -1);
+
+	if (g_pcb[index].exists && !g_pcb[index].waiting) {
+		removeIndex(&queues[g_pcb[index].priority], index);
+	}
+
+	g_pcb[index].exists = false;
+	g_pcb[index].waiting = false;
+
+	if (state->lastDispatched == index) {
+		state->lastDispatched = -1;
+	}
+
+	state->faults++;
+}
+
+/**
+* Reaps children that have exited. Any whose pcb is still in use died
+* without finishing (crashed or was killed) and its pcb is reclaimed
+*/
+void reapChildren(queue_t *queues, simstate_t *state, config_t *config) {
+	struct signalfd_siginfo info;
+	pid_t pid;
 	int i;
 
-	// Clear terminal (*nix systems only)
-	printf("\033[2J");
+	// Nothing to do unless a child exited since last time
+	if (read(g_sigFd, &info, sizeof(info)) != sizeof(info)) {
+		return;
+	}
+
+	while (read(g_sigFd, &info, sizeof(info)) == sizeof(info));
+
+	while ((pid = waitpid(-1, NULL, WNOHANG)) > 0) {
+		for (i = 0; i < config->numProcess; i++) {
+			if (g_pcb[i].exists && g_pcb[i].id == pid) {
+				reclaimPcb(i, queues, state, config, false);
+			}
+		}
+	}
+}
+
+/**
+* Changes the number of priority queues of a running simulation.
+* Processes in removed queues are moved, in order, to the new lowest queue
+* Returns false if memory could not be allocated or quantums not built
+*/
+bool resizeQueues(queue_t **queues, int **quantums, int oldCount, config_t *config) {
+	int newCount = config->numQueues;
+	queue_t *newQueues;
+	int *newQuantums;
+	int i;
+
+	if ((newQueues = calloc(newCount, sizeof(queue_t))) == NULL 
+			|| (newQuantums = calloc(newCount, sizeof(int))) == NULL) {
+		return false;
+	}
+
+	for (i = 0; i < newCount; i++) {
+		newQueues[i] = (i < oldCount) ? (*queues)[i] : createQueue();
+	}
+
+	if (!buildQuantums(config, newQuantums)) {
+		free(newQueues);
+		free(newQuantums);
+		return false;
+	}
+
+	// Drain removed queues into the last remaining one
+	for (i = newCount; i < oldCount; i++) {
+		while ((*queues)[i].size != 0) {
+			int index = pop(&(*queues)[i]);
+			g_pcb[index].priority = newCount - 1;
+			push(&newQueues[newCount - 1], index);
+		}
+	}
+
+	// Processes waiting on I/O keep their level, it must still exist
+	for (i = 0; i < config->numProcess; i++) {
+		if (g_pcb[i].priority >= newCount) {
+			g_pcb[i].priority = newCount - 1;
+		}
+	}
+
+	free(*queues);
+	free(*quantums);
+
+	*queues = newQueues;
+	*quantums = newQuantums;
+
+	return true;
+}
+
+/**
+* Draws the status of the system, only rows that changed are redrawn
+*/
+void printStatus(render_t *render, int pcbIndex, int numProcess, int numQueues, queue_t *queues) {
+	stime_t inSystem;
+	int i;
 
 	// Prints the status of each entry in the PCB
 	
-	printf("PCB:\n");
+	setRow(render, "PCB:");
 
 	for (i = 0; i < numProcess; i++) {
-		printf("%2d |", i);
+		setRow(render, "%2d |", i);
 		if (g_pcb[i].exists) {
-			printf("PID: %d ", g_pcb[i].id);
-			printf("|Time in system: %2d.%-9d ", 
-				g_stime->sec - g_pcb[i].startTime.sec, g_stime->nnsec - g_pcb[i].startTime.nnsec);
-			printf("|Time waiting: %2d.%-9d ", g_pcb[i].sysWaitTime.sec, g_pcb[i].sysWaitTime.nnsec);
+			inSystem = toStime(combined(g_stime) - combined(&g_pcb[i].startTime));
+			appendRow(render, "PID: %d ", g_pcb[i].id);
+			appendRow(render, "|Time in system: %2d.%-9d ", inSystem.sec, inSystem.nnsec);
+			appendRow(render, "|Time waiting: %2d.%-9d ", g_pcb[i].sysWaitTime.sec, g_pcb[i].sysWaitTime.nnsec);
 			if (g_pcb[i].waiting) {
-				printf("*Waiting on I/O*");
+				appendRow(render, "*Waiting on I/O*");
 			}
 		}
-		printf("\n");
 	}
 
 	// Print which processes are waiting on I/O
 
-	printf("I/O Wait Queue:");
+	setRow(render, "I/O Wait Queue:");
 
 	for (i = 0; i < numProcess; i++) {
 		if (g_pcb[i].exists && g_pcb[i].waiting) {
-			printf(" |%d|", g_pcb[i].id);
+			appendRow(render, " |%d|", g_pcb[i].id);
 		}
 	}
 
 	// Print the processes in each of the queues
 
-	printf("\n");
-
 	for (i = 0; i < numQueues; i++) {
-		printf("Queue %d:", i);
+		setRow(render, "Queue %d:", i);
 
 		node_t *current = queues[i].head;
 
 		while (current != NULL) {
-			printf(" |%d|", g_pcb[current->index].id);
+			appendRow(render, " |%d|", g_pcb[current->index].id);
 
 			current = current->next;
 		}
-
-		printf("\n");
 	}
 
-	printf("Simulated system time: %d.%d\n", g_stime->sec, g_stime->nnsec);
+	setRow(render, "Simulated system time: %d.%d", g_stime->sec, g_stime->nnsec);
 
-	printf("Process scheduled: ");
+	setRow(render, "Process scheduled: ");
 
 	if (pcbIndex != -1) {
-		printf("|%d|", g_pcb[pcbIndex].id);
+		appendRow(render, "|%d|", g_pcb[pcbIndex].id);
 		if (g_pcb[pcbIndex].waiting) {
-			printf(" *I/O*");
+			appendRow(render, " *I/O*");
 		}
 		else if (!g_pcb[pcbIndex].exists) {
-			printf(" *Finished*");
+			appendRow(render, " *Finished*");
 		}
-		printf("\n");
 	}
 	else {
-		printf("None\n");
+		appendRow(render, "None");
 	}
+
+	drawFrame(render);
 }
 
 /**
@@ -375,44 +783,53 @@ int main(int argc, char **argv) {
 			"-h: displays this help message\n"
 			"-s [integer]: number of child processes to generate (max 18)\n"
 			"-t [integer]: number of seconds OSS will wait\n"
-			"-l [filename]: name of file where log will be written\n";
+			"-l [filename]: name of file where log will be written\n"
+			"-c [filename]: name of file where checkpoints will be written\n"
+			"-r [filename]: resume the simulation from a checkpoint file\n"
+			"-p, --config [filename]: read more preferences from a file (repeatable)\n"
+			"-o, --set [key=value]: override a single preference (repeatable)\n"
+			"-i: inline mode, processes are simulated inside OSS (no children)\n"
+			"-q: quiet, no status display and no sleeping between cycles\n"
+			"-b [integer]: simulated nanoseconds to run before branching into what-if clones\n"
+			"-w [name=v1,v2,...]: what-if values, one clone per value (repeatable)\n"
+			"    names: quantumFactor, numQueues, agingThreshold, maxIoWait\n";
+	struct option longOpts[] = {
+		{"help", no_argument, NULL, 'h'},
+		{"config", required_argument, NULL, 'p'},
+		{"set", required_argument, NULL, 'o'},
+		{NULL, 0, NULL, 0}
+	};
 	int c = 0;
 
-	char *filename = DFLT_FILEN;
-	
-	// Read values from the pref file and store them in an array
-	int prefs[14];
-	readPreferences(prefs);
+	char *resumeFile = NULL;
+	bool quiet = false;
+
+	// What-if branching, variants[0] is always the unchanged baseline
+	long long branchTime = -1;
+	variant_t variants[MAX_VARIANTS] = {{PARAM_NONE, 0, 0, 0}};
+	int numVariants = 1;
+	int variant = -1;
+	int oldQueues;
+
+	// Queue a process moves to after a dispatch, and if it used its allotment
+	int level;
+	bool exhausted;
 	
-	// Assign the values read from the pref file to their respective variables
-	int numProcess = prefs[0];
-	int numQueues = prefs[1];
-	int waitReal = prefs[2];
-	int waitSim = prefs[3];
-	int generateRate = prefs[4];
-	int quantumFactor = prefs[5];
-	int workMax = prefs[6];
-	int maxLines = prefs[7];
-	int intMin = prefs[8];
-	int intMax = prefs[9];
-	int termMin = prefs[10];
-	int termMax = prefs[11];
-	int sleepAmount = prefs[12];
-	int maxIoWait = prefs[13];
+	// Preferences, defaults overridden by pref.dat then the command line
+	config_t config;
 
 	// process variables
 	int i = 0;
 	int pcbIndex = -1;
 	int workTime;
+	long long overhead;
 	
-	// Used to track when to generate a new child
-	stime_t generateTime = {0, 0};
+	// Loop state carried between cycles: when to generate the next child,
+	// when to write the next checkpoint, statistics and the random stream
+	simstate_t state = {.lineCount = 1, .lastDispatched = -1};
 
 	// Used to track statistics
-	stime_t cpuIdleTime = {0, 0};
-	stime_t totalWait = {0, 0};
 	stime_t averageWait = {0, 0};
-	stime_t totalTurn = {0, 0};
 	stime_t averageTurn = {0, 0};
 
 	// Priority queues -- where processes wait to be scheduled
@@ -422,9 +839,11 @@ int main(int argc, char **argv) {
 	// Quantum coresponding to each priority queue
 	int *quantums;
 
-	int lineCount = 1;
-	int totalProcesses = 0;
-	int totalFinished = 0;
+	// Distribution of the time between spawns
+	dist_t arrival;
+
+	// Status display, keeps the last frame so only changes are redrawn
+	static render_t render;
 
 	char logBuff[128];
 
@@ -433,7 +852,8 @@ int main(int argc, char **argv) {
 	struct sigaction sa;
 
 	struct oss_msgbuf ossBuf;
-	struct sch_msgbuf schBuf;
+	reply_t reply;
+	result_t result;
 
 	// Setup signal handler for SIGINT
 
@@ -446,27 +866,85 @@ int main(int argc, char **argv) {
 		return 1;
     }
 
-	// Handle getopt
-	while ( (c = getopt( argc, argv, "hs:l:t:" )) != -1 ) {
+	// SIGUSR1 requests a checkpoint, interrupted calls should carry on
+	sa.sa_flags = SA_RESTART;
+
+	if (sigaction(SIGUSR1, &sa, NULL) == -1) {
+        perror("Error: cannot handle SIGUSR1");
+		return 1;
+    }
+
+	// Built in defaults, then pref.dat if there is one
+	defaultConfig(&config);
+
+	if (access(DFLT_PREFS, F_OK) == 0 && !loadConfig(&config, DFLT_PREFS)) {
+		return 1;
+	}
+
+	// Handle getopt, preferences are applied in the order given
+	while ( (c = getopt_long( argc, argv, "hs:l:t:c:r:p:o:iqb:w:", longOpts, NULL )) != -1 ) {
 		switch ( c ) {
 			case 'h':
 				printf(helpMsg, argv[0]);
 				return 0;
 			// Number of simultaneous processes 
 			case 's':
-				numProcess = strtol(optarg, NULL, 10);
-				if (numProcess > 18) {
-					fprintf(stderr, "Max number of simultaneous processes is 18\n");
+				if (!setPref(&config, "numProcess", optarg)) {
 					return 1;
 				}
 				break;
 			// File to save log entries to
 			case 'l':
-				filename = strdup(optarg);
+				if (!setPref(&config, "logFile", optarg)) {
+					return 1;
+				}
 				break;
 			// Max number of real-time seconds OSS runs for
 			case 't':
-				waitReal = strtol(optarg, NULL, 10);
+				if (!setPref(&config, "waitReal", optarg)) {
+					return 1;
+				}
+				break;
+			// File to write checkpoints to
+			case 'c':
+				if (!setPref(&config, "checkpointFile", optarg)) {
+					return 1;
+				}
+				break;
+			// Layer another pref file on top
+			case 'p':
+				if (!loadConfig(&config, optarg)) {
+					return 1;
+				}
+				break;
+			// Override one preference
+			case 'o':
+				if (!setConfig(&config, optarg)) {
+					return 1;
+				}
+				break;
+			// Checkpoint file to resume from
+			case 'r':
+				resumeFile = strdup(optarg);
+				break;
+			// Simulate processes inside OSS
+			case 'i':
+				g_inline = true;
+				break;
+			// No status display or sleeping
+			case 'q':
+				quiet = true;
+				break;
+			// Simulated time of the branch point, clones need inline mode
+			case 'b':
+				branchTime = strtoll(optarg, NULL, 10);
+				g_inline = true;
+				break;
+			// Values to try in the what-if clones
+			case 'w':
+				if ((numVariants = parseVariants(optarg, variants, numVariants, MAX_VARIANTS)) == -1) {
+					return 1;
+				}
 				break;
 			case '?':
 			default:
@@ -475,53 +953,98 @@ int main(int argc, char **argv) {
 		}
 	}
 
+	if (!validateConfig(&config) || !checkVariants(variants, numVariants, &config)) {
+		return 1;
+	}
+
+	arrival.type = config.arrivalDist;
+	arrival.scale = config.generateRate;
+	arrival.shape = config.arrivalShape;
+
+	initWorkload();
+	initRenderer(&render, config.maxFps);
+
 	// Allocate and init shared memory
-	setupMemory(numProcess);
+	setupMemory(config.numProcess);
+
+	// Child exits are watched for from here on
+	if (!g_inline) {
+		setupChildEvents();
+	}
 
 	// Allocate memory for array used for the priority queues	
-	if ((queues = calloc(numQueues, sizeof(queue_t))) == NULL) {
+	if ((queues = calloc(config.numQueues, sizeof(queue_t))) == NULL) {
 		perror("Failed to allocate memory for priority queue array");
 		cleanUp();
 		return 1;
 	}
 
 	// Allocate memory for array used for the queue's quantum	
-	if ((quantums = calloc(numQueues, sizeof(int))) == NULL) {
+	if ((quantums = calloc(config.numQueues, sizeof(int))) == NULL) {
 		perror("Failed to allocate memory for priority queue array");
 		cleanUp();
 		return 1;
 	}
 
-	// Initialize the priority queues and calculate quantums
-	for (i = 0; i < numQueues; i++) {
+	// Initialize the priority queues
+	for (i = 0; i < config.numQueues; i++) {
 		queues[i] = createQueue();
-		// 2^i * quantumFactor
-		quantums[i] = intPow(2, i) * quantumFactor;
 	}
 
-	// Delete old log file if it exists
-	remove(filename);
+	// Calculate quantums once, following the quantum schedule
+	if (!buildQuantums(&config, quantums)) {
+		cleanUp();
+		return 1;
+	}
+
+	// Restore the simulation and recreate its children
+	if (resumeFile != NULL) {
+		if (!loadCheckpoint(resumeFile, &state, g_stime, g_pcb, config.numProcess, queues, config.numQueues)) {
+			cleanUp();
+			return 1;
+		}
+
+		respawnAll(config.numProcess);
+	}
+	else {
+		seedRng(&state.rng, (config.seed != 0) ? config.seed : time(NULL));
+		startSource(&state.source, &state.rng, 0, config.onMean);
+
+		// Delete old log file if it exists
+		remove(config.logFile);
+	}
 
 	// Attempt to open file in append mode
-	if ((g_output = fopen(filename, "a")) == NULL) {
+	if ((g_output = fopen(config.logFile, "a")) == NULL) {
 		perror("Failed to open file in OSS");
 		cleanUp();
 		return 1;
 	}
 
+	// Record what this run was configured with at the top of its log
+	writeToLog("# Effective preferences:\n", &state.lineCount, config.maxLines);
+	dumpConfig(&config, g_output, "# ");
+
 	// The real time in nanoseconds that OSS should terminate if hasn't already finished
-	realEndTime = realTimeSinceEpoch() + (waitReal * ((long long) NS_PER_S));
+	realEndTime = realTimeSinceEpoch() + (config.waitReal * ((long long) NS_PER_S));
 
-	srand(time(NULL));
+	if (config.checkpointInterval > 0 && resumeFile == NULL) {
+		incrementTime(&state.checkpointTime, config.checkpointInterval);
+	}
 
 	// Main loop
 	while (1) {
+		// Reclaim the pcbs of children that crashed or were killed
+		if (!g_inline) {
+			reapChildren(queues, &state, &config);
+		}
+
 		// Generate new child processes if time reached
-		if (gte(g_stime, &generateTime)) {
+		if (gte(g_stime, &state.generateTime)) {
 			int tempIndex = -1;
 
 			// Find if there is a free pcb using the pcbVector
-			for (i = 0; i < numProcess; i++) {
+			for (i = 0; i < config.numProcess; i++) {
 				if (!g_pcb[i].exists) {
 					tempIndex = i;
 					break;
@@ -530,32 +1053,34 @@ int main(int argc, char **argv) {
 
 			// Generate new child process if a free pcb was found
 			if (tempIndex != -1) {
-				generateChild(numProcess, tempIndex, intMin, intMax, termMin, termMax);
+				generateChild(&state.rng, &config, tempIndex, state.totalProcesses + 1);
 
-				totalProcesses++;
+				state.totalProcesses++;
 
 				// Add to queue based on its priority
-				push(&queues[g_pcb[tempIndex].priority], tempIndex);
+				enqueue(queues, g_pcb[tempIndex].priority, tempIndex);
 				
 				snprintf(logBuff, 128, "** OSS: Generating process with PID %d"
 					" and putting in queue %d at time %d.%d\n",
 					g_pcb[tempIndex].id, g_pcb[tempIndex].priority, g_stime->sec, g_stime->nnsec);
 
-				writeToLog(logBuff, &lineCount, maxLines);
+				writeToLog(logBuff, &state.lineCount, config.maxLines);
 			}
 
-			// Time to generate next process
-			generateTime = *g_stime;
-			incrementTime(&generateTime, (rand() % generateRate) + 1);
+			// Time to generate next process, from the arrival distribution
+			state.generateTime = toStime(nextArrival(&arrival, &state.source, &state.rng,
+				combined(g_stime), config.onMean, config.offMean));
 		}
 
-		// Print the current status of the system to terminal
-		printStatus(pcbIndex, numProcess, numQueues, queues);
+		// Print the current status of the system to terminal, at most maxFps times a second
+		if (!quiet && frameDue(&render)) {
+			printStatus(&render, pcbIndex, config.numProcess, config.numQueues, queues);
+		}
 
 		pcbIndex = -1;
 
 		// Check if there is a waiting process whose I/O has returned
-		for (i = 0; i < numProcess; i++) {
+		for (i = 0; i < config.numProcess; i++) {
 			if (g_pcb[i].waiting && gte(g_stime, &g_pcb[i].ioFinishTime)) {
 				g_pcb[i].waiting = false;
 				pcbIndex = i;
@@ -563,10 +1088,28 @@ int main(int argc, char **argv) {
 			}
 		}
 
+		// Promote processes that have waited too long in a lower queue
+		// Queues are in order of arrival, so only the heads need checking
+		if (config.agingThreshold > 0) {
+			for (i = 1; i < config.numQueues; i++) {
+				while (queues[i].size != 0 && agedOut(queues[i].head->index, config.agingThreshold)) {
+					int index = pop(&queues[i]);
+
+					// Allotment starts over at the new level
+					g_pcb[index].levelUsed = 0;
+					enqueue(queues, i - 1, index);
+
+					snprintf(logBuff, 128, "^^ OSS: Aging process with PID %d from queue %d to queue %d\n",
+						g_pcb[index].id, i, i - 1);
+					writeToLog(logBuff, &state.lineCount, config.maxLines);
+				}
+			}
+		}
+
 		// If no waiting processes, find the next ready process to dispatch
 		if (pcbIndex == -1) {
 			// Check each queue in order of priority
-			for (i = 0; i < numQueues; i++) {
+			for (i = 0; i < config.numQueues; i++) {
 				if (queues[i].size != 0) {
 					pcbIndex = pop(&queues[i]);
 					break;
@@ -574,153 +1117,287 @@ int main(int argc, char **argv) {
 			}
 		}
 
-		workTime = (rand() % workMax) + 1;
+		workTime = randInt(&state.rng, config.workMax) + 1;
+
+		// Cost of switching to the process, lost cpu time
+		overhead = (pcbIndex != -1) ? dispatchOverhead(&config, pcbIndex, state.lastDispatched) : 0;
+		state.overheadTime += overhead;
+		state.busyTime += workTime + overhead;
 
 		// Add cpu work time to simulated system time  
-		incrementTime(g_stime, workTime);
+		incrementTime(g_stime, workTime + overhead);
 
 		// Add cpu work time to the wait time of each active pcb
-		for (i = 0; i < numProcess; i++) {
+		for (i = 0; i < config.numProcess; i++) {
 			if (g_pcb[i].exists && !g_pcb[i].waiting) {
-				incrementTime(&g_pcb[i].sysWaitTime, workTime);
+				incrementTime(&g_pcb[i].sysWaitTime, workTime + overhead);
 			}
 		}
 
 		// Schedule child process if one was found waiting
 		if (pcbIndex != -1) {
-			// Message type is set to child pid, child only waits for this type
-			schBuf.mtype = g_pcb[pcbIndex].id;
-
-			// Get quantum for the queue
-			schBuf.quantum = quantums[g_pcb[pcbIndex].priority];
-
 			snprintf(logBuff, 128, "OSS: Dispatching process with PID %d"
 				                    " from queue %d at time %d.%d\n",
 					g_pcb[pcbIndex].id, g_pcb[pcbIndex].priority, g_stime->sec, g_stime->nnsec);
-			writeToLog(logBuff, &lineCount, maxLines);
-
-			// Send message to child proccess (msg type is child pid) to schedule 
-			if (msgsnd(g_mschId, &schBuf, sizeof(struct sch_msgbuf), 0) == -1) {
-					perror("OSS failed to send sch messege");
-					cleanUp();
-					exit(EXIT_FAILURE);
-			}
+			writeToLog(logBuff, &state.lineCount, config.maxLines);
 
 			snprintf(logBuff, 128, "  OSS: Total time this dispatch %d nanoseconds\n",
 					workTime);
-			writeToLog(logBuff, &lineCount, maxLines);
+			writeToLog(logBuff, &state.lineCount, config.maxLines);
 
-			// Wait for return message from child process
-			if (msgrcv(g_mossId, &ossBuf, sizeof(struct oss_msgbuf), 1, 0) == -1){
-					perror("OSS failed to receive return message");
-					cleanUp();
-					exit(EXIT_FAILURE);
+			if (overhead > 0) {
+				snprintf(logBuff, 128, "  OSS: Context switch overhead %lld nanoseconds\n", overhead);
+				writeToLog(logBuff, &state.lineCount, config.maxLines);
 			}
 
-			snprintf(logBuff, 128, "    OSS: Receiving that process with PID %d"
-					" ran for %d nanoseconds\n",
-					g_pcb[pcbIndex].id, g_pcb[pcbIndex].lastBurst);
-			writeToLog(logBuff, &lineCount, maxLines);
+			// Run with the quantum for its queue and wait for the outcome
+			reply = dispatchProcess(pcbIndex, quantums[g_pcb[pcbIndex].priority], &ossBuf, config.replyTimeout);
+			state.dispatches++;
+
+			// A child that died or hung did no work this dispatch
+			if (reply != REPLY_OK) {
+				g_pcb[pcbIndex].lastBurst = 0;
+			}
+			else {
+				snprintf(logBuff, 128, "    OSS: Receiving that process with PID %d"
+						" ran for %d nanoseconds\n",
+						g_pcb[pcbIndex].id, g_pcb[pcbIndex].lastBurst);
+				writeToLog(logBuff, &state.lineCount, config.maxLines);
+			}
 
 			// Increment system time to that of child's last burst
 			incrementTime(g_stime, g_pcb[pcbIndex].lastBurst);
+			state.busyTime += g_pcb[pcbIndex].lastBurst;
+			state.lastDispatched = pcbIndex;
+			g_pcb[pcbIndex].lastRunTime = combined(g_stime);
 
 			// Increment the wait time of any active pcb except the one that just ran
-			for (i = 0; i < numProcess; i++) {
+			for (i = 0; i < config.numProcess; i++) {
 				if (i != pcbIndex && g_pcb[i].exists && !g_pcb[i].waiting) {
 					incrementTime(&g_pcb[i].sysWaitTime, g_pcb[pcbIndex].lastBurst);
 				}
 			}
 
+			// Child never replied, free its pcb
+			if (reply != REPLY_OK) {
+				reclaimPcb(pcbIndex, queues, &state, &config, reply == REPLY_HUNG);
+			}
 			// If child proccess finished this burst
-			if (ossBuf.finished) {
+			else if (ossBuf.finished) {
 				snprintf(logBuff, 128, "XX OSS: Process with PID %d finished at time %d.%d\n",
 					g_pcb[pcbIndex].id, g_stime->sec, g_stime->nnsec);
-				writeToLog(logBuff, &lineCount, maxLines);
+				writeToLog(logBuff, &state.lineCount, config.maxLines);
 
 				// Subtract current time form start time and add it to total turnaround
-				incrementTime(&totalTurn, combined(g_stime) - combined(&g_pcb[pcbIndex].startTime));
+				incrementTime(&state.totalTurn, combined(g_stime) - combined(&g_pcb[pcbIndex].startTime));
 				
 				// Add the pcb's wait time to total wait time
-				incrementTime(&totalWait, combined(&g_pcb[pcbIndex].sysWaitTime));
+				incrementTime(&state.totalWait, combined(&g_pcb[pcbIndex].sysWaitTime));
 
-				// Mark pcb as free
+				// Mark pcb as free, a new process in it needs a full switch
 				g_pcb[pcbIndex].exists = false;
+				state.lastDispatched = -1;
 				g_pcb[pcbIndex].waiting = false;
-				totalFinished++;
+				state.totalFinished++;
 			}
 			// Not finished so find which queue to go to
 			else {
+				level = g_pcb[pcbIndex].priority;
+
+				// With allotments a process moves down once the cpu time used at
+				// its level reaches the allotment, however many dispatches it took,
+				// so yielding just before the quantum ends doesn't keep it up
+				if (config.allotmentFactor > 0) {
+					g_pcb[pcbIndex].levelUsed += g_pcb[pcbIndex].lastBurst;
+					exhausted = g_pcb[pcbIndex].levelUsed >= (long long) config.allotmentFactor * quantums[level];
+				}
+				// Without, using all of a quantum is what moves it down
+				else {
+					exhausted = !ossBuf.interrupt;
+				}
+
+				if (exhausted) {
+					state.allotmentsExhausted[level]++;
+					g_pcb[pcbIndex].levelUsed = 0;
+
+					// Move down one level (unless already at lowest queue)
+					if (level < config.numQueues - 1) {
+						level++;
+						state.demotions++;
+					}
+
+					snprintf(logBuff, 128, "    OSS: Process %d used its allotment, moving to queue %d\n",
+							g_pcb[pcbIndex].id, level);
+					writeToLog(logBuff, &state.lineCount, config.maxLines);
+				}
+
 				// Child process was interrupted
 				if (ossBuf.interrupt) {
-					// After wait is handled, will be reset to priority 0 (highest priority)
-					g_pcb[pcbIndex].priority = -1;
+					// Without allotments, goes back to the top queue once its I/O is done
+					if (config.allotmentFactor == 0) {
+						level = 0;
+					}
+
+					g_pcb[pcbIndex].priority = level;
 
 					snprintf(logBuff, 128, "    OSS: Process %d was interrupted, adding to wait queue\n",
 							g_pcb[pcbIndex].id);
-					writeToLog(logBuff, &lineCount, maxLines);
+					writeToLog(logBuff, &state.lineCount, config.maxLines);
 
 					// Mark as waiting for I/O
 					g_pcb[pcbIndex].waiting = true;
 
 					g_pcb[pcbIndex].ioFinishTime = *g_stime;
-					incrementTime(&g_pcb[pcbIndex].ioFinishTime, (rand() % maxIoWait) + 1);
+					incrementTime(&g_pcb[pcbIndex].ioFinishTime, randInt(&state.rng, config.maxIoWait) + 1);
 				}
-				// Used all of quantum, adjust priority
+				// Used all of quantum, back in the queue for its level
 				else {
-					// Move down one level (unless already at lowest queue)
-					g_pcb[pcbIndex].priority += (g_pcb[pcbIndex].priority < (numQueues - 1));
-
 					// Add to back of proper queue
-					push(&queues[g_pcb[pcbIndex].priority], pcbIndex);
+					enqueue(queues, level, pcbIndex);
 
 					snprintf(logBuff, 128, "      OSS: Putting process with PID %d into queue %d\n",
 						g_pcb[pcbIndex].id, g_pcb[pcbIndex].priority);
-					writeToLog(logBuff, &lineCount, maxLines);
+					writeToLog(logBuff, &state.lineCount, config.maxLines);
 				}
 			}
 		}
 		// No processes to be scheduled, CPU is idle
 		else {
 			// Larger increment needed to get to next process to generate
-			incrementTime(g_stime, rand() % (workMax * 100));
-			incrementTime(&cpuIdleTime, rand() % (workMax * 100));
+			incrementTime(g_stime, randInt(&state.rng, config.workMax * 100));
+			incrementTime(&state.cpuIdleTime, randInt(&state.rng, config.workMax * 100));
 		}
 
 		// Check if OSS has generated the max number of children (total)
-		if (totalProcesses >= 100) {
-			printf("OSS has generated 100 total processes, exiting\n");
+		// (what-if clones stay silent, the parent prints their results)
+		if (state.totalProcesses >= 100) {
+			if (variant == -1) {
+				printf("OSS has generated 100 total processes, exiting\n");
+			}
 			break;
 		}
 
 		// Check for simulated system time reaching end point
-		if (g_stime->sec >= waitSim) {
-			printf("Simulated time ended %d.%d\n", g_stime->sec, g_stime->nnsec);
+		if (g_stime->sec >= config.waitSim) {
+			if (variant == -1) {
+				printf("Simulated time ended %d.%d\n", g_stime->sec, g_stime->nnsec);
+			}
 			break;
 		}
 
 		// Check for real system time reaching end point
 		if (realTimeSinceEpoch() >= realEndTime) {
-			printf("Real time ended\n");
+			if (variant == -1) {
+				printf("Real time ended\n");
+			}
 			break;
 		}
 
+		// Write a checkpoint if the interval was reached or one was requested
+		if (g_checkpointRequested || 
+				(config.checkpointInterval > 0 && gte(g_stime, &state.checkpointTime))) {
+			g_checkpointRequested = 0;
+
+			if (config.checkpointInterval > 0) {
+				state.checkpointTime = *g_stime;
+				incrementTime(&state.checkpointTime, config.checkpointInterval);
+			}
+
+			if (saveCheckpoint(config.checkpointFile, &state, g_stime, g_pcb, config.numProcess, queues, config.numQueues)) {
+				snprintf(logBuff, 128, "## OSS: Checkpoint written to %s at time %d.%d\n",
+					config.checkpointFile, g_stime->sec, g_stime->nnsec);
+			}
+			else {
+				snprintf(logBuff, 128, "## OSS: Failed to write checkpoint to %s: %s\n",
+					config.checkpointFile, strerror(errno));
+			}
+			writeToLog(logBuff, &state.lineCount, config.maxLines);
+		}
+
+		// Reached the branch point, fork one clone per what-if variant
+		if (branchTime >= 0 && variant == -1 && combined(g_stime) >= branchTime) {
+			snprintf(logBuff, 128, "<> OSS: Branching into %d clones at time %d.%d\n",
+				numVariants, g_stime->sec, g_stime->nnsec);
+			writeToLog(logBuff, &state.lineCount, config.maxLines);
+
+			if ((variant = forkVariants(variants, numVariants)) == -1) {
+				printf("Preferences at the branch point:\n");
+				dumpConfig(&config, stdout, "  ");
+				collectResults(variants, numVariants);
+				cleanUp();
+				return 0;
+			}
+
+			// In the clone: own log, no display, no checkpoints
+			snprintf(logBuff, 128, "%s.%d", config.logFile, variant);
+			fclose(g_output);
+
+			if ((g_output = fopen(logBuff, "w")) == NULL) {
+				perror("Failed to open clone log file in OSS");
+				exit(EXIT_FAILURE);
+			}
+
+			quiet = true;
+			config.checkpointInterval = 0;
+
+			oldQueues = config.numQueues;
+			applyVariant(&variants[variant], &config);
+
+			// Rebuilds the quantums too, quantumFactor may have changed
+			if (!resizeQueues(&queues, &quantums, oldQueues, &config)) {
+				fprintf(stderr, "Failed to resize priority queues in what-if clone\n");
+				cleanUp();
+				exit(EXIT_FAILURE);
+			}
+
+			writeToLog("# Effective preferences of this clone:\n", &state.lineCount, config.maxLines);
+			dumpConfig(&config, g_output, "# ");
+		}
+
 		// Allows printed status of system to be viewable to user
-		usleep(sleepAmount);
+		if (!quiet) {
+			usleep(config.sleepAmount);
+		}
 	}	
 
+	fprintf(stderr, "DBG loop ended\n");
 	// Kill all active processes
-	abortAll(numProcess);
+	abortAll(config.numProcess);
 
 	cleanUp();
 
 	// Calculate average wait and turnaround time
-	if (totalFinished != 0) {
-		incrementTime(&averageWait, combined(&totalWait) / totalFinished);
-		incrementTime(&averageTurn, combined(&totalTurn) / totalFinished);
+	if (state.totalFinished != 0) {
+		incrementTime(&averageWait, combined(&state.totalWait) / state.totalFinished);
+		incrementTime(&averageTurn, combined(&state.totalTurn) / state.totalFinished);
+	}
+
+	// What-if clones report back to the parent instead of printing
+	if (variant != -1) {
+		result.cpuIdleTime = state.cpuIdleTime;
+		result.averageWait = averageWait;
+		result.averageTurn = averageTurn;
+		result.totalProcesses = state.totalProcesses;
+		result.totalFinished = state.totalFinished;
+		result.dispatches = state.dispatches;
+
+		return sendResult(variants[variant].fd, &result) ? 0 : 1;
 	}
 
-	printf("CPU Idle: %d.%d\n", cpuIdleTime.sec, cpuIdleTime.nnsec);
+	printf("Effective preferences:\n");
+	dumpConfig(&config, stdout, "  ");
+	printf("CPU Idle: %d.%d\n", state.cpuIdleTime.sec, state.cpuIdleTime.nnsec);
+	printf("Context switch overhead: %lld.%09lld (%.2f%% of busy cpu time)\n",
+		state.overheadTime / NS_PER_S, state.overheadTime % NS_PER_S,
+		(state.busyTime > 0) ? 100.0 * state.overheadTime / state.busyTime : 0.0);
+	printf("Demotions: %lld, allotments used up per queue:", state.demotions);
+	for (i = 0; i < config.numQueues; i++) {
+		printf(" %lld", state.allotmentsExhausted[i]);
+	}
+	printf("\n");
+	if (state.faults > 0) {
+		printf("Faulted processes (died or hung): %lld\n", state.faults);
+	}
 	printf("Average time waiting: %d.%d\n", averageWait.sec, averageWait.nnsec);
 	printf("Average turnover: %d.%d\n", averageTurn.sec, averageTurn.nnsec);
 	printf("OSS exiting...\n");
@@ -10,6 +10,8 @@
 #define OSS_H
 
 #include "stime.h"
+#include "rng.h"
+#include "workload.h"
 
 // C boolean type
 typedef enum {false, true} bool;
@@ -28,12 +30,29 @@ typedef struct pcb_t {
 	bool exists;
 	bool waiting;
 	int priority;
+	// CPU time used at the current priority, for allotments
+	long long levelUsed;
 	int lastBurst;
 	stime_t sysWaitTime;
 	stime_t ioFinishTime;
 	stime_t startTime;
+	// When it was last put in a ready queue, used for aging
+	stime_t queuedTime;
+	// Simulated time (nanoseconds) it last stopped running, -1 if never run
+	long long lastRunTime;
+	// Chances (1 in n) of I/O interrupt and termination each dispatch
+	int intProb;
+	int termProb;
+	// Random stream used by the process, kept here so it is checkpointed
+	rng_t rng;
+	// Workload class and how long its bursts before I/O or termination are
+	int class;
+	dist_t burst;
 } pcb_t;
 
+// Outcome of waiting for a dispatched Process to reply
+typedef enum {REPLY_OK, REPLY_DEAD, REPLY_HUNG} reply_t;
+
 // Struct for sending message to Process when it has been scheduled 
 struct sch_msgbuf {
 	long mtype;
@@ -5,12 +5,13 @@
 * Summary: Instance of Process is execed when OSS forks a new child.
 * Process spin-locks on a shared message queue until that Process 
 * is "dispatched" by OSS. When that happens, Process randomly
-* decides (based on probabilities sent as command line args) whether
+* decides (based on probabilities stored in its pcb, see behave.c) whether
 * it should be interrupted by I/O, terminate, or just use its full
 * quantum. Process sends a message back to OSS at the end of each
 * dispatch.
 */
 #include "oss.h"
+#include "behave.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -144,9 +145,6 @@ void sigHandler(int sig) {
 int main(int argc, char **argv) {
 	int pcbIndex;
 	int numProcess;
-	int quantum;
-	int interruptProb;
-	int terminateProb;
 	int msgId = getpid();
 	struct sigaction sa;
 	struct sch_msgbuf schBuf;
@@ -156,8 +154,6 @@ int main(int argc, char **argv) {
 	// Get vars passed from OSS as command line args
 	pcbIndex = strtol(argv[0], NULL, 10);
 	numProcess = strtol(argv[1], NULL, 10);
-	interruptProb = strtol(argv[2], NULL, 10);
-	terminateProb = strtol(argv[3], NULL, 10);
 
 	// Setup signal handlers
 
@@ -175,19 +171,27 @@ int main(int argc, char **argv) {
 		exit(EXIT_FAILURE);
 	}
 
+	// SIGUSR1 asks OSS for a checkpoint, it is not meant for children
+	sa.sa_handler = SIG_IGN;
+
+	if (sigaction(SIGUSR1, &sa, NULL) == -1) {
+        perror("Error: Process cannot ignore SIGUSR1");
+		exit(EXIT_FAILURE);
+	}
+
 	// Attach to shared memory
 	attachMemory(numProcess);
 
+	// Tables used to sample burst lengths
+	initWorkload();
+
 	// Reference to this prcoesses pcb in shared memory
 	pcb = &g_pcb[pcbIndex];
 
-	// Seed random, changing seed based on pid
-	srand(time(NULL) ^ (getpid() << 16));
-
 	// Main loop
 	while (1) {
 		// Wait to be scheduled by OSS -- message type is our pid
-		if (msgrcv(g_mschId, &schBuf, sizeof(struct sch_msgbuf), msgId, 0) == -1){
+		if (msgrcv(g_mschId, &schBuf, sizeof(struct sch_msgbuf) - sizeof(long), msgId, 0) == -1){
 			fprintf(stderr, "Process %d failed to receive schedule message: %s", getpid(), strerror(errno));
 			cleanUp();
 			exit(EXIT_FAILURE);
@@ -195,34 +199,18 @@ int main(int argc, char **argv) {
 
 		// Set initial values of return message
 		ossBuf.mtype = 1;
-		ossBuf.finished = false;
-		ossBuf.interrupt = false;
 		ossBuf.index = pcbIndex;
 
-		quantum = schBuf.quantum;
+		// Decide how the quantum is used, sets interrupt and finished
+		pcb->lastBurst = runBurst(pcb, schBuf.quantum, &ossBuf.interrupt, &ossBuf.finished);
 
-		// Check for termination using the termination probability
-		// 1 in terminateProb chance of terminating this cycle
-		if ((rand() % terminateProb) == (terminateProb - 1)) {
-			// How much of this quantum to use before terminating
-			quantum = rand() % (quantum + 1);
-			pcb->lastBurst = quantum;
-			ossBuf.finished = true;
+		if (ossBuf.finished) {
 			// Break main loop
 			break;
 		}
 
-		// Check for interrupt using the interrupt probability
-		if ((rand() % interruptProb) == (interruptProb - 1)) {
-			// How much of this quantum to use before the interrupt occurs
-			quantum = rand() % (quantum + 1);
-			ossBuf.interrupt = true;
-		}
-
-		pcb->lastBurst = quantum;
-
 		// If not termination, pass lock back to message queue
-		if (msgsnd(g_mossId, &ossBuf, sizeof(struct oss_msgbuf), 0) == -1) {
+		if (msgsnd(g_mossId, &ossBuf, sizeof(struct oss_msgbuf) - sizeof(long), 0) == -1) {
 			fprintf(stderr, "Process %d failed to send OSS message: %s", getpid(), strerror(errno));
 			cleanUp();
 			exit(EXIT_FAILURE);
@@ -230,7 +218,7 @@ int main(int argc, char **argv) {
 	}
 	
 	// Send final message back to OSS -- no blocked waiting, just send and gtfo
-	if (msgsnd(g_mossId, &ossBuf, sizeof(struct oss_msgbuf), IPC_NOWAIT) == -1) {
+	if (msgsnd(g_mossId, &ossBuf, sizeof(struct oss_msgbuf) - sizeof(long), IPC_NOWAIT) == -1) {
 		fprintf(stderr, "Process %d failed to send OSS term message: %s", getpid(), strerror(errno));
 		cleanUp();
 		exit(EXIT_FAILURE);
@@ -0,0 +1,68 @@
+/**
+* quantum.c
+* Author: Gabriel Murphy
+* Date: Mon Oct 19 2026
+* Summary: Calculates the quantum of each priority queue once, at start-up,
+* following the schedule chosen in the preferences:
+* geometric: 2^i * quantumFactor
+* linear: (i + 1) * quantumFactor
+* list: the i-th value of quantumList
+*/
+#include "quantum.h"
+#include <stdio.h>
+#include <limits.h>
+
+/**
+* Power function, returns base**exp
+* Unlike math.h pow, is integer based
+*/
+int intPow(int base, unsigned int exp) {
+	unsigned int i;
+	int result = 1;
+
+	for (i = 0; i < exp; i++) {
+		result *= base;
+	}
+
+	return result;
+}
+
+/**
+* Fills quantums (one per queue) following the quantum schedule.
+* Returns false (with a message on stderr) if a quantum would not fit
+* in an int or the list doesn't have a value for every queue
+*/
+bool buildQuantums(config_t *config, int *quantums) {
+	long long quantum;
+	int i;
+
+	for (i = 0; i < config->numQueues; i++) {
+		switch (config->quantumSchedule) {
+			case SCHEDULE_LINEAR:
+				quantum = (long long) config->quantumFactor * (i + 1);
+				break;
+			case SCHEDULE_LIST:
+				if (i >= config->quantumList.count) {
+					fprintf(stderr, "quantumList has no quantum for queue %d\n", i);
+					return false;
+				}
+				quantum = config->quantumList.values[i];
+				break;
+			case SCHEDULE_GEOMETRIC:
+			default:
+				// Shifting more than 31 would overflow even a factor of 1
+				quantum = (i < 31) ? (long long) config->quantumFactor << i : LLONG_MAX;
+				break;
+		}
+
+		if (quantum > INT_MAX) {
+			fprintf(stderr, "Quantum of queue %d overflows with quantumFactor %d\n",
+				i, config->quantumFactor);
+			return false;
+		}
+
+		quantums[i] = (int) quantum;
+	}
+
+	return true;
+}
@@ -0,0 +1,16 @@
+/**
+* quantum.h
+* Author: Gabriel Murphy
+* Date: Mon Oct 19 2026
+* Summary: Builds the table of quantums, one per priority queue
+*/
+#ifndef QUANTUM_H
+#define QUANTUM_H
+
+#include "config.h"
+
+int intPow(int, unsigned int);
+
+bool buildQuantums(config_t *, int *);
+
+#endif
@@ -52,6 +52,41 @@ int pop(queue_t *queue) {
 	return index;
 }
 
+/**
+* Removes the node holding index from anywhere in the queue
+* Returns 1 if it was found, 0 if not
+*/
+int removeIndex(queue_t *queue, int index) {
+	node_t *node = queue->head;
+	node_t *prev = NULL;
+
+	while (node != NULL && node->index != index) {
+		prev = node;
+		node = node->next;
+	}
+
+	if (node == NULL) {
+		return 0;
+	}
+
+	if (prev == NULL) {
+		queue->head = node->next;
+	}
+	else {
+		prev->next = node->next;
+	}
+
+	if (queue->tail == node) {
+		queue->tail = prev;
+	}
+
+	free(node);
+
+	queue->size--;
+
+	return 1;
+}
+
 /**
 * Prints the contents of the queue
 * Really only used during debugging the project
@@ -22,6 +22,8 @@ void push(queue_t *, int);
 
 int pop(queue_t *);
 
+int removeIndex(queue_t *, int);
+
 void printQueue(queue_t *);
 
 queue_t createQueue();
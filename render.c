@@ -0,0 +1,147 @@
+/**
+* render.c
+* Author: Gabriel Murphy
+* Date: Mon Oct 19 2026
+* Summary: Builds frames row by row, then emits only the rows that differ
+* from the previous frame using cursor positioning escapes (*nix terminals)
+*/
+#include "render.h"
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+
+/**
+* Monotonic wall-clock time in nanoseconds, used to cap the refresh rate
+*/
+static long long wallClock() {
+	struct timespec timeSpec;
+
+	clock_gettime(CLOCK_MONOTONIC, &timeSpec);
+
+	return (long long) timeSpec.tv_sec * 1000000000LL + timeSpec.tv_nsec;
+}
+
+/**
+* Sets up an empty renderer drawing at most maxFps frames per second
+* (0 for no limit)
+*/
+void initRenderer(render_t *render, int maxFps) {
+	memset(render, 0, sizeof(render_t));
+
+	render->interval = (maxFps > 0) ? 1000000000LL / maxFps : 0;
+	render->lastFrame = wallClock() - render->interval;
+}
+
+/**
+* Checks if enough wall-clock time has passed to draw another frame
+* If so starts a new, empty frame
+*/
+bool frameDue(render_t *render) {
+	long long now = wallClock();
+
+	if (now - render->lastFrame < render->interval) {
+		return false;
+	}
+
+	render->lastFrame = now;
+	render->rows = 0;
+
+	return true;
+}
+
+/**
+* Adds a new row to the frame being built, printf style
+*/
+void setRow(render_t *render, const char *format, ...) {
+	va_list args;
+
+	if (render->rows == MAX_ROWS) {
+		return;
+	}
+
+	va_start(args, format);
+	vsnprintf(render->next[render->rows], ROW_LEN, format, args);
+	va_end(args);
+
+	render->rows++;
+}
+
+/**
+* Appends to the last row of the frame being built, printf style
+*/
+void appendRow(render_t *render, const char *format, ...) {
+	va_list args;
+	char *row;
+	size_t len;
+
+	if (render->rows == 0) {
+		return;
+	}
+
+	row = render->next[render->rows - 1];
+	len = strlen(row);
+
+	va_start(args, format);
+	vsnprintf(row + len, ROW_LEN - len, format, args);
+	va_end(args);
+}
+
+/**
+* Writes all of buff, retrying partial and interrupted writes
+*/
+static void writeAll(const char *buff, size_t len) {
+	ssize_t written;
+
+	while (len > 0) {
+		if ((written = write(STDOUT_FILENO, buff, len)) == -1) {
+			if (errno == EINTR) {
+				continue;
+			}
+			return;
+		}
+
+		buff += written;
+		len -= written;
+	}
+}
+
+/**
+* Draws the frame that was built, only the rows that changed since the
+* last frame are written. Rows the last frame had but this one doesn't
+* are cleared. Leaves the cursor on the line below the frame
+*/
+void drawFrame(render_t *render) {
+	int len = 0;
+	int rows = (render->rows > render->prevRows) ? render->rows : render->prevRows;
+	int i;
+
+	// First frame starts from a clear screen
+	if (!render->drawn) {
+		len += sprintf(render->out + len, "\033[2J");
+		render->drawn = true;
+	}
+
+	for (i = 0; i < rows; i++) {
+		if (i >= render->rows) {
+			render->next[i][0] = '\0';
+		}
+		else if (i < render->prevRows && strcmp(render->next[i], render->prev[i]) == 0) {
+			continue;
+		}
+
+		// Move to row, write it and clear whatever was left of the old one
+		len += sprintf(render->out + len, "\033[%d;1H%s\033[K", i + 1, render->next[i]);
+		strcpy(render->prev[i], render->next[i]);
+	}
+
+	len += sprintf(render->out + len, "\033[%d;1H", render->rows + 1);
+
+	render->prevRows = render->rows;
+
+	// Anything printed with stdio must reach the terminal first
+	fflush(stdout);
+	writeAll(render->out, len);
+}
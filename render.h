@@ -0,0 +1,39 @@
+/**
+* render.h
+* Author: Gabriel Murphy
+* Date: Mon Oct 19 2026
+* Summary: Incremental terminal renderer for the status display. Keeps the
+* previous frame and only redraws rows that changed, writing each frame
+* with a single write()
+*/
+#ifndef RENDER_H
+#define RENDER_H
+
+#include "oss.h"
+
+// Max rows in a frame and characters in a row (longer rows are cut off)
+#define MAX_ROWS 64
+#define ROW_LEN 256
+
+typedef struct render_t {
+	char prev[MAX_ROWS][ROW_LEN];
+	char next[MAX_ROWS][ROW_LEN];
+	int prevRows;
+	int rows;
+	bool drawn;
+	long long interval;
+	long long lastFrame;
+	char out[MAX_ROWS * (ROW_LEN + 16) + 32];
+} render_t;
+
+void initRenderer(render_t *, int);
+
+bool frameDue(render_t *);
+
+void setRow(render_t *, const char *, ...);
+
+void appendRow(render_t *, const char *, ...);
+
+void drawFrame(render_t *);
+
+#endif
@@ -0,0 +1,37 @@
+/**
+* rng.c
+* Author: Gabriel Murphy
+* Date: Mon Oct 19 2026
+* Summary: splitmix64 based random number generator used in place of rand()
+*/
+#include "rng.h"
+
+/**
+* Seeds the generator, a seed of 0 is valid
+*/
+void seedRng(rng_t *rng, unsigned long long seed) {
+	rng->state = seed;
+}
+
+/**
+* Returns the next random number in [0, 2^31), same range as rand()
+*/
+int nextRand(rng_t *rng) {
+	unsigned long long z;
+
+	rng->state += 0x9E3779B97F4A7C15ULL;
+
+	z = rng->state;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	z = z ^ (z >> 31);
+
+	return (int) (z >> 33);
+}
+
+/**
+* Returns a random number in [0, n), n must be greater than 0
+*/
+int randInt(rng_t *rng, int n) {
+	return nextRand(rng) % n;
+}
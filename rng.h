@@ -0,0 +1,21 @@
+/**
+* rng.h
+* Author: Gabriel Murphy
+* Date: Mon Oct 19 2026
+* Summary: Small seedable random number generator. Its whole state is a
+* single integer so it can live in shared memory and be checkpointed
+*/
+#ifndef RNG_H
+#define RNG_H
+
+typedef struct rng_t {
+	unsigned long long state;
+} rng_t;
+
+void seedRng(rng_t *, unsigned long long);
+
+int nextRand(rng_t *);
+
+int randInt(rng_t *, int);
+
+#endif
@@ -10,26 +10,24 @@
 * Increments a given stime struct by a number of nanoseconds
 */
 void incrementTime(stime_t *time, long long delta) {
-	// Done this way to avoid overflowing nnsec, probably simpler way TODO
+	time->sec += delta / NS_PER_S;
+	time->nnsec += delta % NS_PER_S;
 
-	// delta (in nanoseconds) is less than one full second
-	if (delta < NS_PER_S) {
-		time->nnsec += delta;
-
-		if (time->nnsec >= NS_PER_S) {
-			time->sec++;
-			time->nnsec -= NS_PER_S;
-		}
+	if (time->nnsec >= NS_PER_S) {
+		time->sec++;
+		time->nnsec -= NS_PER_S;
 	}
-	// delta is great than or equal to one full second
-	else {
-		while (delta >= NS_PER_S) {
-			time->sec++;
-			delta -= NS_PER_S;
-		}
-
-		time->nnsec = delta;
-	}	
+}
+
+/**
+* Converts a full time in nanoseconds to an stime struct
+*/
+stime_t toStime(long long time) {
+	stime_t result = {0, 0};
+
+	incrementTime(&result, time);
+
+	return result;
 }
 
 /**
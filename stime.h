@@ -21,4 +21,6 @@ int gte(stime_t *, stime_t *);
 
 long long combined(stime_t *);
 
+stime_t toStime(long long);
+
 #endif
\ No newline at end of file
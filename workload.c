@@ -0,0 +1,184 @@
+/**
+* workload.c
+* Author: Gabriel Murphy
+* Date: Mon Oct 19 2026
+* Summary: Fast sampling of the workload distributions. Exponential and
+* pareto use their closed form inverse CDF, lognormal uses a table of
+* standard normal quantiles built once by initWorkload(), so no sample
+* needs more than one log or exp
+*/
+#include "workload.h"
+#include <math.h>
+
+// Number of entries in the normal quantile table
+#define NORMAL_TABLE_LEN 4096
+
+// Standard normal quantile at (i + 0.5) / NORMAL_TABLE_LEN, plus a last
+// entry so interpolation never reads past the end
+static double normalTable[NORMAL_TABLE_LEN + 1];
+static int tableBuilt = 0;
+
+/**
+* Quantile (inverse CDF) of the standard normal distribution for p in (0, 1)
+* Rational approximation by Peter Acklam, relative error below 1.2e-9
+*/
+static double normalQuantile(double p) {
+	static const double a[] = {-3.969683028665376e+01, 2.209460984245205e+02,
+		-2.759285104469687e+02, 1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00};
+	static const double b[] = {-5.447609879822406e+01, 1.615858368580409e+02,
+		-1.556989798598866e+02, 6.680131188771972e+01, -1.328068155288572e+01};
+	static const double c[] = {-7.784894002430293e-03, -3.223964580411365e-01,
+		-2.400758277161838e+00, -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00};
+	static const double d[] = {7.784695709041462e-03, 3.224671290700398e-01,
+		2.445134137142996e+00, 3.754408661907416e+00};
+	double q, r;
+
+	// Lower tail
+	if (p < 0.02425) {
+		q = sqrt(-2 * log(p));
+		return (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) /
+			((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1);
+	}
+
+	// Upper tail, symmetric to the lower
+	if (p > 1 - 0.02425) {
+		return -normalQuantile(1 - p);
+	}
+
+	q = p - 0.5;
+	r = q * q;
+
+	return (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r + a[5]) * q /
+		(((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1);
+}
+
+/**
+* Builds the normal quantile table, must be called before sampling
+* Only the first call does anything
+*/
+void initWorkload() {
+	int i;
+
+	if (tableBuilt) {
+		return;
+	}
+
+	for (i = 0; i < NORMAL_TABLE_LEN; i++) {
+		normalTable[i] = normalQuantile((i + 0.5) / NORMAL_TABLE_LEN);
+	}
+
+	normalTable[NORMAL_TABLE_LEN] = normalTable[NORMAL_TABLE_LEN - 1];
+	tableBuilt = 1;
+}
+
+/**
+* Uniform random number in (0, 1), never exactly 0 or 1
+*/
+static double uniform(rng_t *rng) {
+	return (nextRand(rng) + 0.5) / 2147483648.0;
+}
+
+/**
+* Standard normal sample, interpolated from the quantile table
+*/
+static double normal(rng_t *rng) {
+	double position = uniform(rng) * NORMAL_TABLE_LEN - 0.5;
+	int i;
+
+	if (position < 0) {
+		return normalTable[0];
+	}
+
+	i = (int) position;
+
+	return normalTable[i] + (normalTable[i + 1] - normalTable[i]) * (position - i);
+}
+
+/**
+* Draws a sample from the distribution, in nanoseconds (at least 1)
+*/
+long long sampleDist(dist_t *dist, rng_t *rng) {
+	double sample;
+
+	switch (dist->type) {
+		case DIST_EXPONENTIAL:
+			sample = -dist->scale * log(uniform(rng));
+			break;
+		case DIST_PARETO:
+			sample = dist->scale * exp(-log(uniform(rng)) / dist->shape);
+			break;
+		case DIST_LOGNORMAL:
+			sample = dist->scale * exp(dist->shape * normal(rng));
+			break;
+		case DIST_UNIFORM:
+		default:
+			return randInt(rng, (int) dist->scale) + 1;
+	}
+
+	// Keep heavy tails from overflowing the simulated clock
+	if (sample >= 1e15) {
+		return 1000000000000000LL;
+	}
+
+	return (sample < 1) ? 1 : (long long) sample;
+}
+
+/**
+* How much of a quantum a process uses before an I/O interrupt or
+* terminating. Uniform is a uniform fraction of the quantum, the others
+* are a burst length from the distribution cut off at the quantum
+*/
+int sampleBurst(dist_t *dist, rng_t *rng, int quantum) {
+	long long burst;
+
+	if (dist->type == DIST_UNIFORM) {
+		return randInt(rng, quantum + 1);
+	}
+
+	burst = sampleDist(dist, rng);
+
+	return (burst > quantum) ? quantum : (int) burst;
+}
+
+/**
+* Starts an on/off source in the on state at time now
+* A mean off time of 0 means the source is always on
+*/
+void startSource(source_t *source, rng_t *rng, long long now, long long onMean) {
+	dist_t onTime = {DIST_EXPONENTIAL, onMean, 0};
+
+	source->on = 1;
+	source->switchTime = (onMean > 0) ? now + sampleDist(&onTime, rng) : 0;
+}
+
+/**
+* Returns the absolute time (nanoseconds) of the next arrival after now.
+* On/off periods have exponential lengths, arrivals that would fall in an
+* off period are pushed to after it, with a fresh gap once it is back on
+*/
+long long nextArrival(dist_t *arrival, source_t *source, rng_t *rng,
+		long long now, long long onMean, long long offMean) {
+	dist_t onTime = {DIST_EXPONENTIAL, onMean, 0};
+	dist_t offTime = {DIST_EXPONENTIAL, offMean, 0};
+	long long next = now + sampleDist(arrival, rng);
+
+	if (onMean <= 0 || offMean <= 0) {
+		return next;
+	}
+
+	while (next >= source->switchTime) {
+		if (source->on) {
+			// Nothing arrives until the off period is over
+			source->on = 0;
+			source->switchTime += sampleDist(&offTime, rng);
+			next = source->switchTime;
+		}
+		else {
+			source->on = 1;
+			source->switchTime += sampleDist(&onTime, rng);
+			next += sampleDist(arrival, rng);
+		}
+	}
+
+	return next;
+}
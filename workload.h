@@ -0,0 +1,54 @@
+/**
+* workload.h
+* Author: Gabriel Murphy
+* Date: Mon Oct 19 2026
+* Summary: Random distributions used to generate the workload: time between
+* process arrivals (optionally from an on/off bursty source) and the length
+* of the CPU bursts processes run before an I/O interrupt or terminating
+*/
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include "rng.h"
+
+// Shape of a distribution, scale/shape meaning depends on it:
+// uniform: 1 to scale, shape unused
+// exponential: mean of scale (Poisson arrivals), shape unused
+// pareto: minimum of scale, tail index of shape (heavier tail as it shrinks)
+// lognormal: median of scale, sigma of the underlying normal of shape
+typedef enum {
+	DIST_UNIFORM,
+	DIST_EXPONENTIAL,
+	DIST_PARETO,
+	DIST_LOGNORMAL
+} disttype_t;
+
+typedef struct dist_t {
+	int type;
+	double scale;
+	double shape;
+} dist_t;
+
+// Classes of process a workload is a mix of
+typedef enum {
+	CLASS_INTERACTIVE,
+	CLASS_BATCH
+} class_t;
+
+// On/off source, arrivals only happen while it is on
+typedef struct source_t {
+	int on;
+	long long switchTime;
+} source_t;
+
+void initWorkload();
+
+long long sampleDist(dist_t *, rng_t *);
+
+int sampleBurst(dist_t *, rng_t *, int);
+
+void startSource(source_t *, rng_t *, long long, long long);
+
+long long nextArrival(dist_t *, source_t *, rng_t *, long long, long long, long long);
+
+#endif